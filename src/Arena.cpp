@@ -0,0 +1,161 @@
+#include "Arena.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <new>
+#include <stdexcept>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
+
+namespace WayoutPlayer {
+namespace {
+constexpr std::size_t InitialChunkSize = 1u << 20u;
+// Leaves room for the bookkeeping the monotonic buffer may add to its first chunk.
+constexpr std::size_t LargestCachedChunkSize = 2 * InitialChunkSize;
+// Touching one byte of every small page faults in the whole chunk, whether or not it is backed by huge pages.
+constexpr std::size_t PrefaultStride = 4096;
+
+std::size_t roundUpToHugePages(std::size_t bytes) {
+  const auto pageSize = HugePageMemoryResource::HugePageSize;
+  return (bytes + pageSize - 1) / pageSize * pageSize;
+}
+} // namespace
+
+std::string hugePagesToString(HugePages hugePages) {
+  switch (hugePages) {
+  case HugePages::Off:
+    return "off";
+  case HugePages::Transparent:
+    return "transparent";
+  case HugePages::Explicit:
+    return "explicit";
+  }
+  throw std::invalid_argument("Should not be reachable.");
+}
+
+HugePages hugePagesFromString(const std::string &string) {
+  for (const auto hugePages : HugePagesValues) {
+    if (hugePagesToString(hugePages) == string) {
+      return hugePages;
+    }
+  }
+  throw std::invalid_argument("Invalid huge pages setting: " + string + ".");
+}
+
+HugePageMemoryResource::HugePageMemoryResource(HugePages newHugePages, std::pmr::memory_resource *upstreamResource)
+    : hugePages(newHugePages), upstream(upstreamResource) {
+}
+
+void *HugePageMemoryResource::do_allocate(std::size_t bytes, std::size_t alignment) {
+#ifdef __linux__
+  if (hugePages != HugePages::Off && bytes >= HugePageSize && alignment <= HugePageSize) {
+    const auto size = roundUpToHugePages(bytes);
+    if (hugePages == HugePages::Explicit) {
+      const auto flags = MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | MAP_POPULATE;
+      auto *pointer = mmap(nullptr, size, PROT_READ | PROT_WRITE, flags, -1, 0);
+      if (pointer != MAP_FAILED) {
+        return pointer;
+      }
+    }
+    // A huge page more is mapped than needed, so that the chunk can start at a huge page boundary.
+    auto *mapping = static_cast<char *>(mmap(nullptr, size + HugePageSize, PROT_READ | PROT_WRITE,
+                                             MAP_PRIVATE | MAP_ANONYMOUS, -1, 0));
+    if (mapping == MAP_FAILED) {
+      throw std::bad_alloc();
+    }
+    const auto address = reinterpret_cast<std::uintptr_t>(mapping);
+    const auto skipped = (HugePageSize - address % HugePageSize) % HugePageSize;
+    auto *pointer = mapping + skipped;
+    if (skipped > 0) {
+      munmap(mapping, skipped);
+    }
+    munmap(pointer + size, HugePageSize - skipped);
+    madvise(pointer, size, MADV_HUGEPAGE);
+    // Explicit huge pages are faulted in at once by MAP_POPULATE, and so are the chunks which stand in for them. Other
+    // chunks only become resident as they are used, so that runs with a memory limit keep their headroom.
+    if (hugePages == HugePages::Explicit) {
+      for (std::size_t offset = 0; offset < size; offset += PrefaultStride) {
+        static_cast<volatile char *>(pointer)[offset] = 0;
+      }
+    }
+    return pointer;
+  }
+#endif
+  return upstream->allocate(bytes, alignment);
+}
+
+void HugePageMemoryResource::do_deallocate(void *pointer, std::size_t bytes, std::size_t alignment) {
+#ifdef __linux__
+  if (hugePages != HugePages::Off && bytes >= HugePageSize && alignment <= HugePageSize) {
+    munmap(pointer, roundUpToHugePages(bytes));
+    return;
+  }
+#endif
+  upstream->deallocate(pointer, bytes, alignment);
+}
+
+bool HugePageMemoryResource::do_is_equal(const std::pmr::memory_resource &other) const noexcept {
+  return this == &other;
+}
+
+std::pmr::memory_resource *getThreadCacheResource() {
+  thread_local std::pmr::unsynchronized_pool_resource cache(
+      std::pmr::pool_options{0, LargestCachedChunkSize}, std::pmr::new_delete_resource());
+  return &cache;
+}
+
+std::pmr::memory_resource *getSearchResource(HugePages hugePages) {
+  if (hugePages == HugePages::Off) {
+    return getThreadCacheResource();
+  }
+  thread_local HugePageMemoryResource transparentResource(HugePages::Transparent, getThreadCacheResource());
+  thread_local HugePageMemoryResource explicitResource(HugePages::Explicit, getThreadCacheResource());
+  return hugePages == HugePages::Transparent ? &transparentResource : &explicitResource;
+}
+
+CountingMemoryResource::CountingMemoryResource(std::pmr::memory_resource *upstreamResource)
+    : upstream(upstreamResource) {
+}
+
+void *CountingMemoryResource::do_allocate(std::size_t bytes, std::size_t alignment) {
+  auto *pointer = upstream->allocate(bytes, alignment);
+  currentBytes += bytes;
+  peakBytes = std::max(peakBytes, currentBytes);
+  return pointer;
+}
+
+void CountingMemoryResource::do_deallocate(void *pointer, std::size_t bytes, std::size_t alignment) {
+  upstream->deallocate(pointer, bytes, alignment);
+  currentBytes -= bytes;
+}
+
+bool CountingMemoryResource::do_is_equal(const std::pmr::memory_resource &other) const noexcept {
+  return this == &other;
+}
+
+U64 CountingMemoryResource::getCurrentBytes() const {
+  return currentBytes;
+}
+
+U64 CountingMemoryResource::getPeakBytes() const {
+  return peakBytes;
+}
+
+Arena::Arena(std::pmr::memory_resource *upstream)
+    : reserved(upstream), monotonic(InitialChunkSize, &reserved), pool(&monotonic), used(&pool) {
+}
+
+std::pmr::memory_resource *Arena::getResource() {
+  return &used;
+}
+
+U64 Arena::getReservedBytes() const {
+  return reserved.getPeakBytes();
+}
+
+U64 Arena::getPeakUsedBytes() const {
+  return used.getPeakBytes();
+}
+} // namespace WayoutPlayer
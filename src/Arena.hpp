@@ -0,0 +1,121 @@
+#pragma once
+
+#include <array>
+#include <memory_resource>
+#include <string>
+
+#include "Types.hpp"
+
+namespace WayoutPlayer {
+/**
+ * A memory resource which forwards to another resource and counts the bytes it has outstanding.
+ */
+class CountingMemoryResource : public std::pmr::memory_resource {
+  std::pmr::memory_resource *upstream;
+  U64 currentBytes = 0;
+  U64 peakBytes = 0;
+
+  void *do_allocate(std::size_t bytes, std::size_t alignment) override;
+
+  void do_deallocate(void *pointer, std::size_t bytes, std::size_t alignment) override;
+
+  [[nodiscard]] bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override;
+
+public:
+  explicit CountingMemoryResource(std::pmr::memory_resource *upstreamResource = std::pmr::new_delete_resource());
+
+  [[nodiscard]] U64 getCurrentBytes() const;
+
+  [[nodiscard]] U64 getPeakBytes() const;
+};
+
+/**
+ * Returns about how many bytes a node-based hash set holds: a node with a cached hash for every element and a pointer
+ * for every bucket.
+ *
+ * A set which only grows holds the most at the end, so this replaces counting each of its many small allocations.
+ */
+template <typename HashSet> U64 estimateHashSetBytes(const HashSet &set) {
+  const auto nodeBytes = sizeof(typename HashSet::value_type) + sizeof(void *) + sizeof(std::size_t);
+  return set.size() * nodeBytes + set.bucket_count() * sizeof(void *);
+}
+
+/**
+ * How the large chunks of memory of a search are backed by pages.
+ */
+enum class HugePages : U8 { Off, Transparent, Explicit };
+
+constexpr std::array<HugePages, 3> HugePagesValues = {HugePages::Off, HugePages::Transparent, HugePages::Explicit};
+
+std::string hugePagesToString(HugePages hugePages);
+
+HugePages hugePagesFromString(const std::string &string);
+
+/**
+ * A memory resource which maps chunks of at least a huge page directly from the system, taking smaller chunks from
+ * another resource.
+ *
+ * Transparent huge pages are requested with madvise, which the kernel may ignore, and are faulted in as they are used.
+ * Explicit huge pages come from the reserved pool of the kernel and are faulted in at once, and chunks fall back to
+ * transparent huge pages, also faulted in at once, when the pool is exhausted.
+ */
+class HugePageMemoryResource : public std::pmr::memory_resource {
+  HugePages hugePages;
+  std::pmr::memory_resource *upstream;
+
+  void *do_allocate(std::size_t bytes, std::size_t alignment) override;
+
+  void do_deallocate(void *pointer, std::size_t bytes, std::size_t alignment) override;
+
+  [[nodiscard]] bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override;
+
+public:
+  static constexpr std::size_t HugePageSize = 2u << 20u;
+
+  HugePageMemoryResource(HugePages newHugePages, std::pmr::memory_resource *upstreamResource);
+};
+
+/**
+ * Returns a resource which keeps the small chunks freed by the arenas of the calling thread for its later arenas.
+ *
+ * Larger chunks are returned to the system, so a thread which once solved a large board does not hold on to its memory.
+ */
+std::pmr::memory_resource *getThreadCacheResource();
+
+/**
+ * Returns the resource the arenas of the searches of the calling thread take their memory from.
+ */
+std::pmr::memory_resource *getSearchResource(HugePages hugePages);
+
+/**
+ * Scratch memory for a single solve which is released all at once when the arena is destroyed.
+ *
+ * Memory is taken from the system in large chunks by a monotonic buffer. Freed blocks are recycled by a pool, so
+ * containers which grow and shrink, such as queues, do not keep reserving more memory.
+ */
+class Arena {
+  CountingMemoryResource reserved;
+  std::pmr::monotonic_buffer_resource monotonic;
+  std::pmr::unsynchronized_pool_resource pool;
+  CountingMemoryResource used;
+
+public:
+  explicit Arena(std::pmr::memory_resource *upstream = std::pmr::new_delete_resource());
+
+  Arena(const Arena &) = delete;
+
+  Arena &operator=(const Arena &) = delete;
+
+  [[nodiscard]] std::pmr::memory_resource *getResource();
+
+  /**
+   * Returns how many bytes the arena took from its upstream resource.
+   */
+  [[nodiscard]] U64 getReservedBytes() const;
+
+  /**
+   * Returns the largest number of bytes which were allocated from the arena at the same time.
+   */
+  [[nodiscard]] U64 getPeakUsedBytes() const;
+};
+} // namespace WayoutPlayer
@@ -4,7 +4,13 @@
 
 void ArgumentParser::parseArguments(int argc, char **argv) {
   for (int i = 0; i < argc; i++) {
-    arguments.emplace_back(argv[i]);
+    const std::string argument(argv[i]);
+    const auto separator = argument.find('=');
+    if (i > 0 && argument.starts_with("--") && separator != std::string::npos) {
+      options[argument.substr(2, separator - 2)] = argument.substr(separator + 1);
+    } else {
+      arguments.push_back(argument);
+    }
   }
 }
 
@@ -14,3 +20,15 @@ std::string ArgumentParser::getArgument(std::size_t position) const {
   }
   return arguments[position];
 }
+
+std::size_t ArgumentParser::getArgumentCount() const {
+  return arguments.size();
+}
+
+std::optional<std::string> ArgumentParser::getOption(const std::string &name) const {
+  const auto iterator = options.find(name);
+  if (iterator == std::end(options)) {
+    return std::nullopt;
+  }
+  return iterator->second;
+}
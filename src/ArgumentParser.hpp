@@ -1,14 +1,23 @@
 #pragma once
 
+#include <map>
 #include <optional>
 #include <string>
 #include <vector>
 
 class ArgumentParser {
   std::vector<std::string> arguments;
+  std::map<std::string, std::string> options;
 
 public:
   void parseArguments(int argc, char **argv);
 
   std::string getArgument(std::size_t position) const;
+
+  std::size_t getArgumentCount() const;
+
+  /**
+   * Returns the value of an option given as --name=value, which is not counted as an argument.
+   */
+  std::optional<std::string> getOption(const std::string &name) const;
 };
\ No newline at end of file
@@ -0,0 +1,492 @@
+#include "BeamSearchEngine.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <limits>
+#include <optional>
+#include <stdexcept>
+#include <vector>
+
+#include "BitPlane.hpp"
+#include "Bits.hpp"
+#include "BoardLayout.hpp"
+#include "Text.hpp"
+
+namespace WayoutPlayer {
+namespace {
+// Blocked tiles must be unblocked and usually lowered afterwards, so they count twice.
+constexpr S64 BlockedTileScore = 2;
+// The search gives up after this many clicks in a row which do not lower the best score.
+constexpr S32 MaximumStalledLayerCount = 128;
+// Slots of the table of boards kept after earlier clicks per board kept after every click.
+constexpr std::size_t KeptHashSlotsPerBoard = 16;
+
+using Clock = std::chrono::steady_clock;
+
+/**
+ * A board of any size as bit planes indexed by a BoardLayout, with the counts its score is made of.
+ */
+class BeamBoard {
+public:
+  BitPlane up;
+  BitPlane blocked;
+  U64 hash = 0;
+  // Raised tiles other than twins.
+  S64 raisedCount = 0;
+  S64 blockedCount = 0;
+  S64 raisedTwinCount = 0;
+};
+
+/**
+ * Clicks beam boards exactly as Board::activate does, recording every change so that a click can be undone.
+ */
+class BeamSimulator {
+  class Change {
+  public:
+    // A negative index stands for flipping all twins.
+    S32 index;
+    bool up;
+    bool blocked;
+  };
+
+  const BoardLayout &layout;
+  std::vector<U64> upKeys;
+  std::vector<U64> blockedKeys;
+  std::vector<S32> twinIndices;
+  BitPlane twinPlane;
+  U64 twinKey = 0;
+  std::vector<Change> changes;
+  std::vector<S32> inverted;
+  std::optional<bool> twinFinalState;
+  bool twinsWereInStep = false;
+
+  /**
+   * Sets the state of a tile, keeping the hash and the counts of the board up to date.
+   */
+  void assign(BeamBoard &board, S32 index, bool up, bool blocked) const {
+    const auto wasUp = board.up.test(index);
+    const auto wasBlocked = board.blocked.test(index);
+    if (wasUp != up) {
+      board.up.flip(index);
+      board.hash ^= upKeys[index];
+      if (layout.getType(index) == TileType::Twin) {
+        board.raisedTwinCount += up ? 1 : -1;
+      } else {
+        board.raisedCount += up ? 1 : -1;
+      }
+    }
+    if (wasBlocked != blocked) {
+      board.blocked.flip(index);
+      board.hash ^= blockedKeys[index];
+      board.blockedCount += blocked ? 1 : -1;
+    }
+  }
+
+  void flipTwins(BeamBoard &board) const {
+    board.up ^= twinPlane;
+    board.hash ^= twinKey;
+    board.raisedTwinCount = static_cast<S64>(twinIndices.size()) - board.raisedTwinCount;
+  }
+
+  void change(BeamBoard &board, S32 index, bool up, bool blocked) {
+    changes.push_back({index, board.up.test(index), board.blocked.test(index)});
+    assign(board, index, up, blocked);
+  }
+
+  void safeInvert(BeamBoard &board, S32 index, bool clicked) {
+    if (index < 0) {
+      return;
+    }
+    const auto type = getType(board, index);
+    const auto up = board.up.test(index);
+    if (type == TileType::Tap) {
+      if (clicked) {
+        change(board, index, !up, false);
+        inverted.push_back(index);
+      }
+    } else if (type == TileType::Blocked) {
+      if (clicked) {
+        throw std::runtime_error("Cannot click on a blocked tile.");
+      }
+      change(board, index, up, false);
+    } else if (type == TileType::Chain) {
+      change(board, index, !up, false);
+      inverted.push_back(index);
+      // This will work as a default tile unless it was not clicked.
+      if (clicked) {
+        return;
+      }
+      for (const auto neighbor : layout.getNeighbors(index)) {
+        if (neighbor >= 0 && std::find(std::begin(inverted), std::end(inverted), neighbor) == std::end(inverted)) {
+          safeInvert(board, neighbor, false);
+        }
+      }
+    } else if (type == TileType::Twin) {
+      if (!twinFinalState) {
+        twinFinalState = !up;
+      }
+      // Twins in step all flip together at the end of the click.
+      if (!twinsWereInStep) {
+        change(board, index, *twinFinalState, false);
+      }
+    } else {
+      change(board, index, !up, false);
+      inverted.push_back(index);
+    }
+  }
+
+public:
+  explicit BeamSimulator(const BoardLayout &boardLayout)
+      : layout(boardLayout), twinPlane(static_cast<std::size_t>(boardLayout.getTileCount())) {
+    for (S32 index = 0; index < layout.getTileCount(); index++) {
+      upKeys.push_back(mixBits(2 * static_cast<U64>(index) + 1));
+      blockedKeys.push_back(mixBits(2 * static_cast<U64>(index) + 2));
+      if (layout.getType(index) == TileType::Twin) {
+        twinIndices.push_back(index);
+        twinPlane.set(index);
+        twinKey ^= upKeys.back();
+      }
+    }
+  }
+
+  [[nodiscard]] BeamBoard makeBoard(const Board &board) const {
+    BeamBoard beamBoard;
+    beamBoard.up = BitPlane(static_cast<std::size_t>(layout.getTileCount()));
+    beamBoard.blocked = BitPlane(static_cast<std::size_t>(layout.getTileCount()));
+    for (S32 index = 0; index < layout.getTileCount(); index++) {
+      const auto position = layout.getPosition(index);
+      const auto tile = board.getTile(position.i, position.j);
+      assign(beamBoard, index, tile.up, tile.type == TileType::Blocked);
+    }
+    return beamBoard;
+  }
+
+  [[nodiscard]] TileType getType(const BeamBoard &board, S32 index) const {
+    if (board.blocked.test(index)) {
+      return TileType::Blocked;
+    }
+    const auto type = layout.getType(index);
+    return type == TileType::Blocked ? TileType::Default : type;
+  }
+
+  /**
+   * Returns a score which is zero only for solved boards. Twins in step are lowered together, so they count once.
+   */
+  [[nodiscard]] S64 getScore(const BeamBoard &board) const {
+    const auto twinCount = static_cast<S64>(twinIndices.size());
+    const auto twinsOutOfStep = std::min(board.raisedTwinCount, twinCount - board.raisedTwinCount);
+    const auto twinScore = board.raisedTwinCount == 0 ? 0 : 1 + twinsOutOfStep;
+    return board.raisedCount + BlockedTileScore * board.blockedCount + twinScore;
+  }
+
+  /**
+   * Clicks a tile which is not blocked, which can be undone until the next click.
+   */
+  void activate(BeamBoard &board, S32 index) {
+    changes.clear();
+    inverted.clear();
+    twinFinalState.reset();
+    const auto twinCount = static_cast<S64>(twinIndices.size());
+    twinsWereInStep = board.raisedTwinCount == 0 || board.raisedTwinCount == twinCount;
+    const auto type = getType(board, index);
+    const auto &neighbors = layout.getNeighbors(index);
+    safeInvert(board, index, true);
+    if (type == TileType::Default || type == TileType::Tap || type == TileType::Chain || type == TileType::Twin) {
+      for (const auto neighbor : neighbors) {
+        safeInvert(board, neighbor, false);
+      }
+    } else if (type == TileType::Horizontal) {
+      safeInvert(board, neighbors[1], false);
+      safeInvert(board, neighbors[2], false);
+    } else if (type == TileType::Vertical) {
+      safeInvert(board, neighbors[0], false);
+      safeInvert(board, neighbors[3], false);
+    }
+    if (twinFinalState && twinsWereInStep) {
+      flipTwins(board);
+      changes.push_back({-1, false, false});
+    } else if (twinFinalState) {
+      for (const auto twinIndex : twinIndices) {
+        if (board.up.test(twinIndex) != *twinFinalState) {
+          change(board, twinIndex, *twinFinalState, board.blocked.test(twinIndex));
+        }
+      }
+    }
+  }
+
+  void undo(BeamBoard &board) {
+    for (auto change = std::rbegin(changes); change != std::rend(changes); change++) {
+      if (change->index < 0) {
+        flipTwins(board);
+      } else {
+        assign(board, change->index, change->up, change->blocked);
+      }
+    }
+    changes.clear();
+  }
+};
+
+/**
+ * A set of 64-bit hashes with open addressing, which is all that is kept to drop duplicate boards within a layer.
+ */
+class HashSet {
+  std::vector<U64> slots;
+  std::size_t size = 0;
+
+public:
+  void clear(std::size_t expectedSize) {
+    const auto capacity = std::bit_ceil(std::max<std::size_t>(16, 2 * expectedSize));
+    slots.assign(capacity, 0);
+    size = 0;
+  }
+
+  [[nodiscard]] bool contains(U64 hash) const {
+    hash = hash == 0 ? 1 : hash;
+    const auto mask = slots.size() - 1;
+    for (auto slot = static_cast<std::size_t>(mixBits(hash)) & mask;; slot = (slot + 1) & mask) {
+      if (slots[slot] == hash) {
+        return true;
+      }
+      if (slots[slot] == 0) {
+        return false;
+      }
+    }
+  }
+
+  /**
+   * Inserts the hash and returns whether or not it was absent.
+   */
+  bool insert(U64 hash) {
+    if (2 * (size + 1) > slots.size()) {
+      const auto oldSlots = std::move(slots);
+      clear(oldSlots.size());
+      for (const auto oldHash : oldSlots) {
+        if (oldHash != 0) {
+          insert(oldHash);
+        }
+      }
+    }
+    // Zero marks empty slots.
+    hash = hash == 0 ? 1 : hash;
+    const auto mask = slots.size() - 1;
+    for (auto slot = static_cast<std::size_t>(mixBits(hash)) & mask;; slot = (slot + 1) & mask) {
+      if (slots[slot] == hash) {
+        return false;
+      }
+      if (slots[slot] == 0) {
+        slots[slot] = hash;
+        size++;
+        return true;
+      }
+    }
+  }
+};
+
+class Candidate {
+public:
+  S64 score;
+  U64 hash;
+  U32 parent;
+  S32 index;
+
+  bool operator<(const Candidate &rhs) const {
+    return score != rhs.score ? score < rhs.score : hash < rhs.hash;
+  }
+};
+
+/**
+ * A table of the hashes of recently inserted boards, where every hash overwrites the one in its slot, so that its size
+ * never grows.
+ */
+class RecentHashTable {
+  std::vector<U64> slots;
+
+public:
+  explicit RecentHashTable(std::size_t slotCount) : slots(std::bit_ceil(slotCount), 0) {
+  }
+
+  [[nodiscard]] bool contains(U64 hash) const {
+    hash = hash == 0 ? 1 : hash;
+    return slots[static_cast<std::size_t>(mixBits(hash)) & (slots.size() - 1)] == hash;
+  }
+
+  void insert(U64 hash) {
+    // Zero marks empty slots, so the solved board, whose hash is zero, must not be stored as zero.
+    hash = hash == 0 ? 1 : hash;
+    slots[static_cast<std::size_t>(mixBits(hash)) & (slots.size() - 1)] = hash;
+  }
+};
+
+/**
+ * The clicks which led to the boards of the beam, as a tree whose nodes are freed once no kept board descends from
+ * them, so that it only grows with the length of the clicks all kept boards share.
+ */
+class PathTree {
+  class Node {
+  public:
+    U32 parent;
+    S32 index;
+    U32 referenceCount;
+  };
+
+  std::vector<Node> nodes;
+  std::vector<U32> freeNodes;
+
+public:
+  static constexpr U32 Root = std::numeric_limits<U32>::max();
+
+  /**
+   * Returns the node of the path which clicks the tile after the path of the parent, held once.
+   */
+  U32 add(U32 parent, S32 index) {
+    if (parent != Root) {
+      nodes[parent].referenceCount++;
+    }
+    if (freeNodes.empty()) {
+      nodes.push_back({parent, index, 1});
+      return static_cast<U32>(nodes.size() - 1);
+    }
+    const auto node = freeNodes.back();
+    freeNodes.pop_back();
+    nodes[node] = {parent, index, 1};
+    return node;
+  }
+
+  void release(U32 node) {
+    while (node != Root && --nodes[node].referenceCount == 0) {
+      freeNodes.push_back(node);
+      node = nodes[node].parent;
+    }
+  }
+
+  [[nodiscard]] std::vector<S32> getIndices(U32 node) const {
+    std::vector<S32> indices;
+    for (; node != Root; node = nodes[node].parent) {
+      indices.push_back(nodes[node].index);
+    }
+    std::reverse(std::begin(indices), std::end(indices));
+    return indices;
+  }
+};
+} // namespace
+
+BeamSearchEngine::BeamSearchEngine(const SolverConfiguration &configuration) : solverConfiguration(configuration) {
+}
+
+Solution BeamSearchEngine::findSolution(const Board &board) const {
+  if (board.isSolved()) {
+    return Solution({}, true);
+  }
+  const BoardLayout layout(board);
+  const auto tileCount = layout.getTileCount();
+  const auto beamWidth = static_cast<std::size_t>(solverConfiguration.getBeamWidth());
+  const auto flippingOnlyUp = solverConfiguration.isFlippingOnlyUp();
+  const auto deadline = Clock::now() + solverConfiguration.getBeamSearchTimeBudget();
+  BeamSimulator simulator(layout);
+  std::vector<BeamBoard> layer = {simulator.makeBoard(board)};
+  std::vector<BeamBoard> nextLayer;
+  PathTree paths;
+  std::vector<U32> layerPaths = {PathTree::Root};
+  std::vector<U32> nextLayerPaths;
+  std::vector<Candidate> candidates;
+  HashSet seenHashes;
+  // Boards kept after recent clicks are not kept again, so that the beam does not spend itself on undoing clicks.
+  RecentHashTable keptHashes(KeptHashSlotsPerBoard * beamWidth);
+  keptHashes.insert(layer.front().hash);
+  // The last board a tile was considered for, so that each click is tried once per board.
+  std::vector<U32> consideredFor(static_cast<std::size_t>(tileCount), std::numeric_limits<U32>::max());
+  auto bestScore = simulator.getScore(layer.front());
+  S32 stalledLayerCount = 0;
+  U64 exploredNodes = 0;
+  while (!layer.empty() && stalledLayerCount < MaximumStalledLayerCount) {
+    candidates.clear();
+    seenHashes.clear(beamWidth);
+    std::fill(std::begin(consideredFor), std::end(consideredFor), std::numeric_limits<U32>::max());
+    for (U32 parent = 0; parent < layer.size(); parent++) {
+      // A board with large groups of chains takes long to expand, so the clock is checked before every one.
+      if (Clock::now() >= deadline) {
+        const auto exploredNodeCount = toPluralizedString(exploredNodes, "node");
+        throw std::runtime_error("Could not find a solution within the time budget after exploring " +
+                                 exploredNodeCount + ".");
+      }
+      auto &parentBoard = layer[parent];
+      exploredNodes++;
+      const auto tryClick = [&](S32 index) {
+        if (index < 0 || consideredFor[index] == parent) {
+          return;
+        }
+        // As in the other searches, taps are only clicked while they are raised, which lowers them for good.
+        const auto type = simulator.getType(parentBoard, index);
+        const auto up = parentBoard.up.test(index);
+        if (type == TileType::Blocked || (type == TileType::Tap && !up) || (flippingOnlyUp && !up)) {
+          return;
+        }
+        consideredFor[index] = parent;
+        simulator.activate(parentBoard, index);
+        const Candidate candidate{simulator.getScore(parentBoard), parentBoard.hash, parent, index};
+        simulator.undo(parentBoard);
+        // The candidates are a max-heap of the best boards, so the worst one is dropped first.
+        if (candidates.size() == beamWidth && !(candidate < candidates.front())) {
+          return;
+        }
+        if (keptHashes.contains(candidate.hash) || !seenHashes.insert(candidate.hash)) {
+          return;
+        }
+        candidates.push_back(candidate);
+        std::push_heap(std::begin(candidates), std::end(candidates));
+        if (candidates.size() > beamWidth) {
+          std::pop_heap(std::begin(candidates), std::end(candidates));
+          candidates.pop_back();
+        }
+      };
+      // Only clicks which reach a raised or blocked tile directly are tried, and raised twins only by clicking them.
+      for (const auto *plane : {&parentBoard.up, &parentBoard.blocked}) {
+        for (auto tile = plane->findNext(0); tile < plane->getSize(); tile = plane->findNext(tile + 1)) {
+          const auto index = static_cast<S32>(tile);
+          tryClick(index);
+          if (plane == &parentBoard.up && layout.getType(index) == TileType::Twin) {
+            continue;
+          }
+          for (const auto neighbor : layout.getNeighbors(index)) {
+            tryClick(neighbor);
+          }
+        }
+      }
+    }
+    std::sort(std::begin(candidates), std::end(candidates));
+    if (!candidates.empty() && candidates.front().score < bestScore) {
+      bestScore = candidates.front().score;
+      stalledLayerCount = 0;
+    } else {
+      stalledLayerCount++;
+    }
+    nextLayer.clear();
+    nextLayerPaths.clear();
+    for (const auto &candidate : candidates) {
+      auto childBoard = layer[candidate.parent];
+      simulator.activate(childBoard, candidate.index);
+      keptHashes.insert(childBoard.hash);
+      const auto path = paths.add(layerPaths[candidate.parent], candidate.index);
+      if (simulator.getScore(childBoard) == 0) {
+        std::vector<Position> clicks;
+        for (const auto index : paths.getIndices(path)) {
+          clicks.push_back(layout.getPosition(index));
+        }
+        Solution solution(clicks, false);
+        solution.setExploredNodes(exploredNodes);
+        return solution;
+      }
+      nextLayer.push_back(std::move(childBoard));
+      nextLayerPaths.push_back(path);
+    }
+    for (const auto path : layerPaths) {
+      paths.release(path);
+    }
+    std::swap(layer, nextLayer);
+    std::swap(layerPaths, nextLayerPaths);
+  }
+  const auto exploredNodeCount = toPluralizedString(exploredNodes, "node");
+  throw std::runtime_error("Could not find a solution after exploring " + exploredNodeCount + ".");
+}
+} // namespace WayoutPlayer
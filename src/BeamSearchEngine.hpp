@@ -0,0 +1,28 @@
+#pragma once
+
+#include "Board.hpp"
+#include "Solution.hpp"
+#include "SolverConfiguration.hpp"
+
+namespace WayoutPlayer {
+/**
+ * Finds solutions of boards of any size and with any tiles in bounded memory and time, which are usually not optimal.
+ *
+ * Boards are expanded one click at a time as in breadth-first search, but only the configured number of boards with the
+ * best scores are kept after every click. A board scores one for every raised tile other than twins, two for every
+ * blocked tile, and, if any twin is raised, one for the twins plus one for every twin out of step with the others.
+ * Boards are kept as bit planes with Zobrist hashes, so a click is scored and undone in place, and duplicates within a
+ * layer are dropped by their hashes alone.
+ *
+ * The search gives up when the best score stops going down for a number of clicks or when its time budget runs out, so
+ * that its time and memory only depend on the beam width, the size of the board and the budget.
+ */
+class BeamSearchEngine {
+  const SolverConfiguration &solverConfiguration;
+
+public:
+  explicit BeamSearchEngine(const SolverConfiguration &configuration);
+
+  [[nodiscard]] Solution findSolution(const Board &board) const;
+};
+} // namespace WayoutPlayer
@@ -0,0 +1,275 @@
+#include "Arena.hpp"
+#include "ArgumentParser.hpp"
+#include "BoardGenerator.hpp"
+#include "Solver.hpp"
+#include "Text.hpp"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <csignal>
+#include <iomanip>
+#include <iostream>
+#include <memory_resource>
+#include <optional>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+using namespace WayoutPlayer;
+
+namespace {
+const std::string DefaultSizes = "3x3,4x4,5x5,6x6,7x7";
+const std::string DefaultMixes = "D,HV,DDDT,DDDB,DDDC,DDDP";
+
+void printUsage() {
+  std::cout << "Usage:" << '\n';
+  std::cout << "  benchmark [--sizes=" << DefaultSizes << "] [--mixes=" << DefaultMixes << "]" << '\n';
+  std::cout << "            [--density=1] [--clicks=<rows * columns / 3>] [--boards=3] [--seed=1]" << '\n';
+  std::cout << "            [--engine=automatic] [--threads=1] [--time-limit=60] [--memory-limit=4096]" << '\n';
+  std::cout << "            [--huge-pages=off] [--beam-width=1024] [--beam-search-time-budget=10000]" << '\n';
+  std::cout << "  benchmark --probe=<entries>" << '\n';
+}
+
+std::vector<std::string> splitList(const std::string &list) {
+  std::vector<std::string> items;
+  std::stringstream stream(list);
+  std::string item;
+  while (std::getline(stream, item, ',')) {
+    if (!item.empty()) {
+      items.push_back(item);
+    }
+  }
+  return items;
+}
+
+/**
+ * What a configuration measured, which the child process that solved it reports to the parent after every board.
+ */
+class Measurement {
+public:
+  U32 solvedBoards = 0;
+  U32 failedBoards = 0;
+  F64 seconds = 0.0;
+  U64 exploredNodes = 0;
+
+  [[nodiscard]] std::string toString() const {
+    std::stringstream stream;
+    stream << solvedBoards << ' ' << failedBoards << ' ' << seconds << ' ' << exploredNodes << '\n';
+    return stream.str();
+  }
+
+  /**
+   * Reads the last measurement written to the string.
+   */
+  static Measurement fromString(const std::string &string) {
+    Measurement measurement;
+    std::stringstream stream(string);
+    std::string line;
+    while (std::getline(stream, line)) {
+      std::stringstream lineStream(line);
+      lineStream >> measurement.solvedBoards >> measurement.failedBoards;
+      lineStream >> measurement.seconds >> measurement.exploredNodes;
+    }
+    return measurement;
+  }
+};
+
+[[noreturn]] void measureInChild(int outputDescriptor, const Solver &solver, const BoardSpecification &specification,
+                                 U32 boardCount, U64 seed, U32 timeLimit, U64 memoryLimit) {
+  alarm(timeLimit);
+  // Allocations beyond the limit throw, so a board which needs too much memory fails instead of swapping.
+  const rlimit addressSpaceLimit{memoryLimit << 20u, memoryLimit << 20u};
+  setrlimit(RLIMIT_AS, &addressSpaceLimit);
+  BoardGenerator boardGenerator(seed);
+  Measurement measurement;
+  for (U32 boardIndex = 0; boardIndex < boardCount; boardIndex++) {
+    std::optional<GeneratedBoard> generatedBoard;
+    try {
+      generatedBoard = boardGenerator.generate(specification);
+    } catch (const std::exception &exception) {
+      std::cerr << exception.what() << '\n';
+      _exit(1);
+    }
+    const auto start = std::chrono::steady_clock::now();
+    try {
+      const auto solution = solver.findSolution(generatedBoard->board);
+      measurement.solvedBoards++;
+      measurement.exploredNodes += solution.getExploredNodes().value_or(0);
+    } catch (const std::exception &) {
+      measurement.failedBoards++;
+    }
+    measurement.seconds += std::chrono::duration<F64>(std::chrono::steady_clock::now() - start).count();
+    const auto line = measurement.toString();
+    if (write(outputDescriptor, line.data(), line.size()) != static_cast<ssize_t>(line.size())) {
+      _exit(1);
+    }
+  }
+  _exit(0);
+}
+
+/**
+ * Solves the boards of a configuration in a child process, so that its peak memory is measured on its own and a
+ * configuration which runs out of time or memory does not stop the benchmark.
+ */
+void benchmarkConfiguration(const Solver &solver, const BoardSpecification &specification, U32 boardCount, U64 seed,
+                            U32 timeLimit, U64 memoryLimit) {
+  int descriptors[2];
+  if (pipe(descriptors) != 0) {
+    throw std::runtime_error("Failed to create a pipe.");
+  }
+  std::cout.flush();
+  const auto child = fork();
+  if (child < 0) {
+    throw std::runtime_error("Failed to fork.");
+  }
+  if (child == 0) {
+    close(descriptors[0]);
+    measureInChild(descriptors[1], solver, specification, boardCount, seed, timeLimit, memoryLimit);
+  }
+  close(descriptors[1]);
+  std::string output;
+  std::array<char, 4096> buffer{};
+  ssize_t readBytes;
+  while ((readBytes = read(descriptors[0], buffer.data(), buffer.size())) > 0) {
+    output.append(buffer.data(), static_cast<std::size_t>(readBytes));
+  }
+  close(descriptors[0]);
+  int status = 0;
+  rusage resourceUsage{};
+  wait4(child, &status, 0, &resourceUsage);
+  const auto measurement = Measurement::fromString(output);
+  std::string outcome = "done";
+  if (WIFSIGNALED(status)) {
+    outcome = WTERMSIG(status) == SIGALRM ? "timed out" : "killed";
+  } else if (WEXITSTATUS(status) != 0) {
+    outcome = "failed";
+  }
+  const auto attemptedBoards = measurement.solvedBoards + measurement.failedBoards;
+  std::stringstream row;
+  row << "| " << specification.rowCount << "x" << specification.columnCount;
+  row << " | " << specification.typeMix;
+  row << " | " << measurement.solvedBoards << "/" << boardCount;
+  row << " | " << std::fixed << std::setprecision(3);
+  row << (attemptedBoards == 0 ? 0.0 : measurement.seconds / attemptedBoards) << " s";
+  // Failed boards do not report how many nodes they explored.
+  const auto exploredNodes = measurement.solvedBoards == 0 ? 0 : measurement.exploredNodes / measurement.solvedBoards;
+  row << " | " << integerToStringWithThousandSeparators(exploredNodes);
+  // ru_maxrss is in kibibytes.
+  row << " | " << integerToStringWithThousandSeparators(resourceUsage.ru_maxrss / 1024) << " MiB";
+  row << " | " << outcome << " |";
+  std::cout << row.str() << '\n';
+}
+/**
+ * Fills a set of seen boards with as many entries as given and probes it, as searches do, once with every huge pages
+ * setting, so that huge pages can be compared with the default allocator on this machine.
+ */
+void benchmarkProbes(std::size_t entryCount) {
+  std::cout << "| Huge pages | Insertions per second | Probes per second | Minor page faults |" << '\n';
+  std::cout << "| --- | --- | --- | --- |" << '\n';
+  for (const auto hugePages : HugePagesValues) {
+    rusage usageBefore{};
+    getrusage(RUSAGE_SELF, &usageBefore);
+    F64 insertionSeconds = 0.0;
+    F64 probeSeconds = 0.0;
+    {
+      Arena arena(getSearchResource(hugePages));
+      std::pmr::unordered_set<U64> seenBoards(arena.getResource());
+      std::mt19937_64 generator(1);
+      const auto start = std::chrono::steady_clock::now();
+      for (std::size_t i = 0; i < entryCount; i++) {
+        seenBoards.insert(generator());
+      }
+      const auto middle = std::chrono::steady_clock::now();
+      // Every other probe looks for an entry which is in the set, and the others most likely miss.
+      std::mt19937_64 replayedGenerator(1);
+      std::size_t hits = 0;
+      for (std::size_t i = 0; i < 2 * entryCount; i++) {
+        hits += seenBoards.count(i % 2 == 0 ? replayedGenerator() : generator());
+      }
+      const auto end = std::chrono::steady_clock::now();
+      if (hits < entryCount) {
+        throw std::runtime_error("Probes missed entries of the set.");
+      }
+      insertionSeconds = std::chrono::duration<F64>(middle - start).count();
+      probeSeconds = std::chrono::duration<F64>(end - middle).count();
+    }
+    rusage usageAfter{};
+    getrusage(RUSAGE_SELF, &usageAfter);
+    const auto insertionsPerSecond = static_cast<U64>(static_cast<F64>(entryCount) / insertionSeconds);
+    const auto probesPerSecond = static_cast<U64>(static_cast<F64>(2 * entryCount) / probeSeconds);
+    const auto minorPageFaults = static_cast<U64>(usageAfter.ru_minflt - usageBefore.ru_minflt);
+    std::cout << "| " << hugePagesToString(hugePages);
+    std::cout << " | " << integerToStringWithThousandSeparators(insertionsPerSecond);
+    std::cout << " | " << integerToStringWithThousandSeparators(probesPerSecond);
+    std::cout << " | " << integerToStringWithThousandSeparators(minorPageFaults) << " |" << '\n';
+  }
+}
+} // namespace
+
+int main(int argc, char **argv) {
+  try {
+    ArgumentParser argumentParser;
+    argumentParser.parseArguments(argc, argv);
+    if (argumentParser.getArgumentCount() > 1) {
+      printUsage();
+      return 1;
+    }
+    if (const auto entryCount = argumentParser.getOption("probe")) {
+      benchmarkProbes(std::stoull(*entryCount));
+      return 0;
+    }
+    const auto sizes = splitList(argumentParser.getOption("sizes").value_or(DefaultSizes));
+    const auto mixes = splitList(argumentParser.getOption("mixes").value_or(DefaultMixes));
+    const auto density = std::stod(argumentParser.getOption("density").value_or("1"));
+    const auto clicks = argumentParser.getOption("clicks");
+    const auto boardCount = static_cast<U32>(std::stoul(argumentParser.getOption("boards").value_or("3")));
+    const auto seed = static_cast<U64>(std::stoull(argumentParser.getOption("seed").value_or("1")));
+    const auto timeLimit = static_cast<U32>(std::stoul(argumentParser.getOption("time-limit").value_or("60")));
+    const auto memoryLimit = static_cast<U64>(std::stoull(argumentParser.getOption("memory-limit").value_or("4096")));
+    auto solver = Solver();
+    const auto engine = argumentParser.getOption("engine").value_or("automatic");
+    solver.getSolverConfiguration().setEngine(solverEngineFromString(engine));
+    const auto hugePages = argumentParser.getOption("huge-pages").value_or("off");
+    solver.getSolverConfiguration().setHugePages(hugePagesFromString(hugePages));
+    solver.getSolverConfiguration().setThreadCount(std::stoul(argumentParser.getOption("threads").value_or("1")));
+    if (const auto width = argumentParser.getOption("beam-width")) {
+      solver.getSolverConfiguration().setBeamWidth(static_cast<U32>(std::stoul(*width)));
+    }
+    if (const auto budget = argumentParser.getOption("beam-search-time-budget")) {
+      solver.getSolverConfiguration().setBeamSearchTimeBudget(std::chrono::milliseconds(std::stoull(*budget)));
+    }
+    std::cout << "| Size | Mix | Solved | Time per board | Explored nodes per solved board | Peak RSS | Outcome |";
+    std::cout << '\n';
+    std::cout << "| --- | --- | --- | --- | --- | --- | --- |" << '\n';
+    for (const auto &size : sizes) {
+      const auto separator = size.find('x');
+      if (separator == std::string::npos) {
+        throw std::invalid_argument("Invalid size: " + size + ".");
+      }
+      BoardSpecification specification;
+      specification.rowCount = std::stoi(size.substr(0, separator));
+      specification.columnCount = std::stoi(size.substr(separator + 1));
+      specification.density = density;
+      const auto defaultClickCount = std::max(1, specification.rowCount * specification.columnCount / 3);
+      specification.clickCount = clicks ? std::stoul(*clicks) : static_cast<U32>(defaultClickCount);
+      for (const auto &mix : mixes) {
+        specification.typeMix = mix;
+        benchmarkConfiguration(solver, specification, boardCount, seed, timeLimit, memoryLimit);
+      }
+    }
+  } catch (const std::exception &exception) {
+    std::cout << "Threw an exception." << '\n';
+    std::cout << "  " << exception.what() << '\n';
+    printUsage();
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,100 @@
+#include "BitPlane.hpp"
+
+#include <bit>
+#include <stdexcept>
+
+#include "Bits.hpp"
+
+namespace WayoutPlayer {
+namespace {
+constexpr std::size_t WordBits = 64;
+
+/**
+ * Returns the bit of the index within its word.
+ */
+U64 wordBitOf(std::size_t index) {
+  return bitOf(static_cast<S32>(index % WordBits));
+}
+} // namespace
+
+BitPlane::BitPlane(std::size_t size) : words((size + WordBits - 1) / WordBits), bitCount(size) {
+}
+
+std::size_t BitPlane::getSize() const {
+  return bitCount;
+}
+
+bool BitPlane::test(std::size_t index) const {
+  return (words[index / WordBits] & wordBitOf(index)) != 0;
+}
+
+void BitPlane::set(std::size_t index) {
+  words[index / WordBits] |= wordBitOf(index);
+}
+
+void BitPlane::flip(std::size_t index) {
+  words[index / WordBits] ^= wordBitOf(index);
+}
+
+bool BitPlane::isZero() const {
+  for (const auto word : words) {
+    if (word != 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+std::size_t BitPlane::count() const {
+  std::size_t setBits = 0;
+  for (const auto word : words) {
+    setBits += static_cast<std::size_t>(std::popcount(word));
+  }
+  return setBits;
+}
+
+std::size_t BitPlane::findNext(std::size_t index) const {
+  if (index >= bitCount) {
+    return bitCount;
+  }
+  auto wordIndex = index / WordBits;
+  // Bits below the index are cleared from its word.
+  auto word = words[wordIndex] & ~(wordBitOf(index) - 1);
+  while (word == 0) {
+    if (++wordIndex == words.size()) {
+      return bitCount;
+    }
+    word = words[wordIndex];
+  }
+  return wordIndex * WordBits + static_cast<std::size_t>(std::countr_zero(word));
+}
+
+bool BitPlane::dot(const BitPlane &rhs) const {
+  if (rhs.bitCount != bitCount) {
+    throw std::invalid_argument("Bit planes should have the same size.");
+  }
+  U64 parity = 0;
+  for (std::size_t i = 0; i < words.size(); i++) {
+    parity ^= words[i] & rhs.words[i];
+  }
+  return (std::popcount(parity) & 1) != 0;
+}
+
+BitPlane &BitPlane::operator^=(const BitPlane &rhs) {
+  if (rhs.bitCount != bitCount) {
+    throw std::invalid_argument("Bit planes should have the same size.");
+  }
+  for (std::size_t i = 0; i < words.size(); i++) {
+    words[i] ^= rhs.words[i];
+  }
+  return *this;
+}
+
+bool BitPlane::operator==(const BitPlane &rhs) const {
+  return bitCount == rhs.bitCount && words == rhs.words;
+}
+
+bool BitPlane::operator!=(const BitPlane &rhs) const {
+  return !(*this == rhs);
+}
+} // namespace WayoutPlayer
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "Types.hpp"
+
+namespace WayoutPlayer {
+/**
+ * A plane of bits of a size chosen at run time, stored in as many 64-bit words as it needs.
+ *
+ * Where a PackedBoard holds one bit for each of at most 64 tiles, a plane holds one bit for each tile of a board of any
+ * size, or one coefficient for each unknown of a linear equation over GF(2).
+ */
+class BitPlane {
+  std::vector<U64> words;
+  std::size_t bitCount = 0;
+
+public:
+  BitPlane() = default;
+
+  explicit BitPlane(std::size_t size);
+
+  [[nodiscard]] std::size_t getSize() const;
+
+  [[nodiscard]] bool test(std::size_t index) const;
+
+  void set(std::size_t index);
+
+  void flip(std::size_t index);
+
+  [[nodiscard]] bool isZero() const;
+
+  /**
+   * Returns the number of set bits.
+   */
+  [[nodiscard]] std::size_t count() const;
+
+  /**
+   * Returns the index of the lowest set bit at or after the index, or the size of the plane if there is none.
+   */
+  [[nodiscard]] std::size_t findNext(std::size_t index) const;
+
+  /**
+   * Returns whether or not an odd number of bits are set in both planes, which is their dot product over GF(2).
+   */
+  [[nodiscard]] bool dot(const BitPlane &rhs) const;
+
+  BitPlane &operator^=(const BitPlane &rhs);
+
+  bool operator==(const BitPlane &rhs) const;
+
+  bool operator!=(const BitPlane &rhs) const;
+};
+} // namespace WayoutPlayer
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+#include "Types.hpp"
+
+// These are defined here rather than in a translation unit as the searches call them in their innermost loops.
+namespace WayoutPlayer {
+constexpr U64 bitOf(S32 index) {
+  return U64{1} << static_cast<U32>(index);
+}
+
+/**
+ * Scrambles the bits of the value, so that hashes of boards which differ in a few tiles spread over a table.
+ */
+constexpr U64 mixBits(U64 value) {
+  // The finalizer of SplitMix64.
+  value = (value ^ (value >> 30u)) * 0xbf58476d1ce4e5b9u;
+  value = (value ^ (value >> 27u)) * 0x94d049bb133111ebu;
+  return value ^ (value >> 31u);
+}
+
+/**
+ * Gathers the bits of the value selected by the mask into the lowest bits, keeping their order.
+ */
+constexpr U64 extractBits(U64 value, U64 mask) {
+  U64 extracted = 0;
+  U32 position = 0;
+  for (; mask != 0; mask &= mask - 1) {
+    if ((value & mask & -mask) != 0) {
+      extracted |= U64{1} << position;
+    }
+    position++;
+  }
+  return extracted;
+}
+
+/**
+ * Spreads the lowest bits of the value over the bits selected by the mask, keeping their order.
+ */
+constexpr U64 depositBits(U64 value, U64 mask) {
+  U64 deposited = 0;
+  for (; mask != 0; mask &= mask - 1) {
+    if ((value & 1u) != 0) {
+      deposited |= mask & -mask;
+    }
+    value >>= 1u;
+  }
+  return deposited;
+}
+
+/**
+ * Appends the value to the bytes in little-endian order.
+ */
+template <typename T, typename Bytes> void writeInteger(Bytes &bytes, T value) {
+  for (std::size_t i = 0; i < sizeof(T); i++) {
+    bytes.push_back(static_cast<char>(static_cast<U64>(value) >> (8 * i) & 0xffu));
+  }
+}
+
+/**
+ * Reads a value written by writeInteger at the offset, throwing if the bytes of the named format end before it.
+ */
+template <typename T> T readInteger(std::string_view bytes, std::size_t offset, std::string_view format) {
+  if (offset > bytes.size() || bytes.size() - offset < sizeof(T)) {
+    throw std::invalid_argument(std::string(format) + " is truncated.");
+  }
+  U64 value = 0;
+  for (std::size_t i = 0; i < sizeof(T); i++) {
+    value |= static_cast<U64>(static_cast<U8>(bytes[offset + i])) << (8 * i);
+  }
+  return static_cast<T>(value);
+}
+} // namespace WayoutPlayer
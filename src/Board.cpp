@@ -3,17 +3,62 @@
 #include <boost/functional/hash.hpp>
 
 namespace WayoutPlayer {
+namespace {
+void checkSides(S32 rowCount, S32 columnCount) {
+  if (rowCount <= 0 || columnCount <= 0) {
+    throw std::invalid_argument("Board should have at least one row and one column.");
+  }
+  const auto maximumSide = static_cast<S32>(std::numeric_limits<IndexType>::max());
+  if (rowCount > maximumSide || columnCount > maximumSide) {
+    const auto limitString = std::to_string(maximumSide);
+    throw std::invalid_argument("Board should have at most " + limitString + " rows and columns.");
+  }
+}
+
+TileWindow findTileWindow(S32 rowCount, S32 columnCount, const std::vector<std::optional<Tile>> &tileVector) {
+  auto firstRow = rowCount;
+  auto firstColumn = columnCount;
+  auto lastRow = -1;
+  auto lastColumn = -1;
+  for (S32 i = 0; i < rowCount; i++) {
+    for (S32 j = 0; j < columnCount; j++) {
+      if (tileVector[i * columnCount + j]) {
+        firstRow = std::min(firstRow, i);
+        firstColumn = std::min(firstColumn, j);
+        lastRow = std::max(lastRow, i);
+        lastColumn = std::max(lastColumn, j);
+      }
+    }
+  }
+  if (lastRow < 0) {
+    return {};
+  }
+  return {firstRow, firstColumn, lastRow - firstRow + 1, lastColumn - firstColumn + 1};
+}
+
+/**
+ * Returns whether some tile may need to be clicked more than once, which is only the case with blocked tiles and twins.
+ *
+ * Two clicks on a tile cancel out unless the first one unblocked a tile or the twins end up in the state set by the
+ * first change of a twin.
+ */
+bool hasTileNeedingMultipleClicks(const std::vector<std::optional<Tile>> &tiles) {
+  return std::any_of(std::begin(tiles), std::end(tiles), [](const auto &tile) {
+    return tile && (tile->type == TileType::Blocked || tile->type == TileType::Twin);
+  });
+}
+} // namespace
 
 S32 Board::getRowCount() const {
-  return static_cast<S32>(matrix.size());
+  return rowCount;
 }
 
 S32 Board::getColumnCount() const {
-  return static_cast<S32>(matrix.front().size());
+  return columnCount;
 }
 
 bool Board::mayNeedMultipleClicks() const {
-  return startedWithBlockedTiles;
+  return startedNeedingMultipleClicks;
 }
 
 bool Board::canBeSolvedOptimallyDirectionally() const {
@@ -30,22 +75,43 @@ bool Board::canBeSolvedOptimallyDirectionally() const {
   return true;
 }
 
+bool Board::hasCommutativeClicks() const {
+  std::optional<bool> twinState;
+  for (S32 i = 0; i < getRowCount(); i++) {
+    for (S32 j = 0; j < getColumnCount(); j++) {
+      if (hasTile(i, j)) {
+        const auto tile = getTile(i, j);
+        if (tile.type == TileType::Blocked) {
+          return false;
+        }
+        if (tile.type == TileType::Twin) {
+          if (twinState && *twinState != tile.up) {
+            return false;
+          }
+          twinState = tile.up;
+        }
+      }
+    }
+  }
+  return true;
+}
+
 void Board::safeInvert(IndexType i, IndexType j, bool clicked, InversionHistory &history) {
   if (!hasTile(i, j)) {
     return;
   }
-  if (matrix[i][j]->type == TileType::Tap) {
+  if (tileAt(i, j)->type == TileType::Tap) {
     if (clicked) {
-      matrix[i][j]->up = !matrix[i][j]->up;
+      tileAt(i, j)->up = !tileAt(i, j)->up;
       history.inversions.emplace_back(i, j);
     }
-  } else if (matrix[i][j]->type == TileType::Blocked) {
+  } else if (tileAt(i, j)->type == TileType::Blocked) {
     if (clicked) {
       throw std::runtime_error("Cannot click on a blocked tile.");
     }
-    matrix[i][j]->type = TileType::Default;
-  } else if (matrix[i][j]->type == TileType::Chain) {
-    matrix[i][j]->up = !matrix[i][j]->up;
+    tileAt(i, j)->type = TileType::Default;
+  } else if (tileAt(i, j)->type == TileType::Chain) {
+    tileAt(i, j)->up = !tileAt(i, j)->up;
     history.inversions.emplace_back(i, j);
     // This will work as a default tile unless it was not clicked.
     if (clicked) {
@@ -62,29 +128,70 @@ void Board::safeInvert(IndexType i, IndexType j, bool clicked, InversionHistory
     propagate(i, j - 1);
     propagate(i, j + 1);
     propagate(i + 1, j);
-  } else if (matrix[i][j]->type == TileType::Twin) {
+  } else if (tileAt(i, j)->type == TileType::Twin) {
     if (!history.twinFinalState) {
-      history.twinFinalState = !matrix[i][j]->up;
+      history.twinFinalState = !tileAt(i, j)->up;
     }
-    matrix[i][j]->up = *history.twinFinalState;
+    tileAt(i, j)->up = *history.twinFinalState;
   } else {
-    matrix[i][j]->up = !matrix[i][j]->up;
+    tileAt(i, j)->up = !tileAt(i, j)->up;
     history.inversions.emplace_back(i, j);
   }
 }
 
-Board::Board(std::vector<std::vector<std::optional<Tile>>> tileMatrix) : matrix(std::move(tileMatrix)) {
-  const auto firstRowSize = matrix.front().size();
-  for (const auto &row : matrix) {
-    if (row.size() != firstRowSize) {
-      throw std::invalid_argument("Matrix is not rectangular.");
-    }
-    for (const auto tile : row) {
-      if (tile && tile->type == TileType::Blocked) {
-        startedWithBlockedTiles = true;
-      }
+bool TileWindow::contains(S32 i, S32 j) const {
+  return i >= firstRow && i < firstRow + rowCount && j >= firstColumn && j < firstColumn + columnCount;
+}
+
+std::optional<Tile> &Board::tileAt(S32 i, S32 j) {
+  return tiles[(i - window.firstRow) * window.columnCount + (j - window.firstColumn)];
+}
+
+const std::optional<Tile> &Board::tileAt(S32 i, S32 j) const {
+  static const std::optional<Tile> NoTile;
+  if (!window.contains(i, j)) {
+    return NoTile;
+  }
+  return tiles[(i - window.firstRow) * window.columnCount + (j - window.firstColumn)];
+}
+
+Board::Board(S32 rows, S32 columns, std::vector<std::optional<Tile>> tileVector)
+    : rowCount(rows), columnCount(columns) {
+  checkSides(rowCount, columnCount);
+  if (tileVector.size() != static_cast<std::size_t>(rowCount) * static_cast<std::size_t>(columnCount)) {
+    throw std::invalid_argument("Matrix is not rectangular.");
+  }
+  window = findTileWindow(rowCount, columnCount, tileVector);
+  if (window.rowCount == rowCount && window.columnCount == columnCount) {
+    tiles = std::move(tileVector);
+  } else {
+    tiles.reserve(static_cast<std::size_t>(window.rowCount) * static_cast<std::size_t>(window.columnCount));
+    for (auto i = window.firstRow; i < window.firstRow + window.rowCount; i++) {
+      const auto rowBegin = std::begin(tileVector) + i * columnCount + window.firstColumn;
+      tiles.insert(std::end(tiles), rowBegin, rowBegin + window.columnCount);
     }
   }
+  startedNeedingMultipleClicks = hasTileNeedingMultipleClicks(tiles);
+}
+
+Board::Board(S32 rows, S32 columns, const TileWindow &tileWindow, std::vector<std::optional<Tile>> windowTiles)
+    : rowCount(rows), columnCount(columns), window(tileWindow), tiles(std::move(windowTiles)) {
+  checkSides(rowCount, columnCount);
+  startedNeedingMultipleClicks = hasTileNeedingMultipleClicks(tiles);
+}
+
+Board::Board(const std::vector<std::vector<std::optional<Tile>>> &tileMatrix)
+    : Board(static_cast<S32>(tileMatrix.size()), tileMatrix.empty() ? 0 : static_cast<S32>(tileMatrix.front().size()),
+            [&tileMatrix]() {
+              std::vector<std::optional<Tile>> tileVector;
+              for (const auto &row : tileMatrix) {
+                if (row.size() != tileMatrix.front().size()) {
+                  throw std::invalid_argument("Matrix is not rectangular.");
+                }
+                tileVector.insert(std::end(tileVector), std::begin(row), std::end(row));
+              }
+              return tileVector;
+            }()) {
 }
 
 bool Board::hasUnsolvedTilesAtRow(IndexType i) const {
@@ -93,7 +200,7 @@ bool Board::hasUnsolvedTilesAtRow(IndexType i) const {
   }
   for (S32 j = 0; j < getColumnCount(); j++) {
     if (hasTile(i, j)) {
-      if (matrix[i][j]->up || matrix[i][j]->type == TileType::Blocked) {
+      if (tileAt(i, j)->up || tileAt(i, j)->type == TileType::Blocked) {
         return true;
       }
     }
@@ -102,21 +209,17 @@ bool Board::hasUnsolvedTilesAtRow(IndexType i) const {
 }
 
 bool Board::hasTile(IndexType i, IndexType j) const {
-  return i >= 0 && i < getRowCount() && j >= 0 && j < getColumnCount() && matrix[i][j].has_value();
+  return i >= 0 && i < getRowCount() && j >= 0 && j < getColumnCount() && tileAt(i, j).has_value();
 }
 
 Tile Board::getTile(IndexType i, IndexType j) const {
-  return matrix[i][j].value();
+  return tileAt(i, j).value();
 }
 
 bool Board::isSolved() const {
-  for (S32 i = 0; i < getRowCount(); i++) {
-    for (S32 j = 0; j < getColumnCount(); j++) {
-      if (hasTile(i, j)) {
-        if (matrix[i][j]->up || matrix[i][j]->type == TileType::Blocked) {
-          return false;
-        }
-      }
+  for (const auto &tile : tiles) {
+    if (tile && (tile->up || tile->type == TileType::Blocked)) {
+      return false;
     }
   }
   return true;
@@ -154,8 +257,8 @@ void Board::activate(IndexType i, IndexType j) {
           continue;
         }
         if (hasTile(otherI, otherJ)) {
-          if (matrix[otherI][otherJ]->type == TileType::Twin) {
-            matrix[otherI][otherJ]->up = *history.twinFinalState;
+          if (tileAt(otherI, otherJ)->type == TileType::Twin) {
+            tileAt(otherI, otherJ)->up = *history.twinFinalState;
           }
         }
       }
@@ -165,19 +268,20 @@ void Board::activate(IndexType i, IndexType j) {
 
 std::size_t Board::hash() const {
   std::size_t seed = 0;
-  for (S32 i = 0; i < getRowCount(); i++) {
-    for (S32 j = 0; j < getColumnCount(); j++) {
-      if (hasTile(i, j)) {
-        boost::hash_combine(seed, tileTypeToInteger(matrix[i][j]->type));
-        boost::hash_combine(seed, matrix[i][j]->up);
-      }
+  for (const auto &tile : tiles) {
+    if (tile) {
+      boost::hash_combine(seed, tileTypeToInteger(tile->type));
+      boost::hash_combine(seed, tile->up);
     }
   }
   return seed;
 }
 
 bool Board::operator==(const Board &rhs) const {
-  return matrix == rhs.matrix;
+  // The window of a board is the rectangle around its tiles, so boards with the same tiles have the same window.
+  return rowCount == rhs.rowCount && columnCount == rhs.columnCount && window.firstRow == rhs.window.firstRow &&
+         window.firstColumn == rhs.window.firstColumn && window.rowCount == rhs.window.rowCount &&
+         window.columnCount == rhs.window.columnCount && tiles == rhs.tiles;
 }
 
 bool Board::operator!=(const Board &rhs) const {
@@ -187,73 +291,86 @@ bool Board::operator!=(const Board &rhs) const {
 std::vector<Board> Board::splitComponents() const {
   using TagType = U32;
   const auto NoTag = std::numeric_limits<TagType>::max();
-  using TaggedTileMatrix = std::vector<std::vector<TagType>>;
-  const auto rowCount = getRowCount();
-  const auto columnCount = getColumnCount();
-  TaggedTileMatrix tagMatrix(rowCount, std::vector<TagType>(columnCount, NoTag));
+  const auto rows = getRowCount();
+  const auto columns = getColumnCount();
+  // Tags are kept in row-major order, and tiles are tagged from an explicit stack, as a recursion as deep as the number
+  // of tiles would overflow the call stack on large boards.
+  std::vector<TagType> tags(static_cast<std::size_t>(rows) * columns, NoTag);
   TagType currentTag = 0;
   auto foundTwin = false;
-  using PositionFunction = std::function<void(S32, S32)>;
-  const PositionFunction propagateTag = [this, &tagMatrix, &currentTag, &foundTwin, &propagateTag](S32 i, S32 j) {
-    if (!hasTile(i, j)) {
-      return;
+  std::vector<Position> stack;
+  const auto pushUntagged = [this, &tags, &stack, NoTag, columns](S32 i, S32 j) {
+    if (hasTile(i, j) && tags[i * columns + j] == NoTag) {
+      stack.emplace_back(static_cast<IndexType>(i), static_cast<IndexType>(j));
     }
-    if (tagMatrix[i][j] == NoTag) {
-      tagMatrix[i][j] = currentTag;
-      // Propagate to all other twins.
-      const auto rowCount = getRowCount();
-      const auto columnCount = getColumnCount();
-      if (getTile(i, j).type == TileType::Twin) {
-        // This check is important to prevent an infinite recursion.
-        if (!foundTwin) {
+  };
+  for (S32 startI = 0; startI < rows; startI++) {
+    for (S32 startJ = 0; startJ < columns; startJ++) {
+      if (!hasTile(startI, startJ) || tags[startI * columns + startJ] != NoTag) {
+        continue;
+      }
+      pushUntagged(startI, startJ);
+      while (!stack.empty()) {
+        const auto [i, j] = stack.back();
+        stack.pop_back();
+        auto &tag = tags[i * columns + j];
+        if (tag != NoTag) {
+          continue;
+        }
+        tag = currentTag;
+        // All twins are in the same component, so they only need to be found once.
+        if (getTile(i, j).type == TileType::Twin && !foundTwin) {
           foundTwin = true;
-          for (S32 oi = 0; oi < rowCount; oi++) {
-            for (S32 oj = 0; oj < columnCount; oj++) {
-              if (oi == i && oj == j) {
-                continue;
-              }
-              if (hasTile(oi, oj)) {
-                if (getTile(oi, oj).type == TileType::Twin) {
-                  propagateTag(oi, oj);
-                }
+          for (S32 oi = 0; oi < rows; oi++) {
+            for (S32 oj = 0; oj < columns; oj++) {
+              if (hasTile(oi, oj) && getTile(oi, oj).type == TileType::Twin) {
+                pushUntagged(oi, oj);
               }
             }
           }
         }
+        pushUntagged(i - 1, j);
+        pushUntagged(i, j - 1);
+        pushUntagged(i, j + 1);
+        pushUntagged(i + 1, j);
       }
-      propagateTag(i - 1, j);
-      propagateTag(i, j - 1);
-      propagateTag(i, j + 1);
-      propagateTag(i + 1, j);
-    } else if (tagMatrix[i][j] != currentTag) {
-      throw std::runtime_error("Should not happen: found a tile tagged with another tag while propagating a tag.");
+      currentTag++;
     }
-  };
-  for (S32 i = 0; i < rowCount; i++) {
-    for (S32 j = 0; j < columnCount; j++) {
-      if (hasTile(i, j)) {
-        if (tagMatrix[i][j] == NoTag) {
-          propagateTag(i, j);
-          currentTag++;
-        }
+  }
+  const auto componentCount = currentTag;
+  std::vector<TileWindow> windows(componentCount, TileWindow{rows, columns, 0, 0});
+  std::vector<Position> lastPositions(componentCount, Position(-1, -1));
+  for (S32 i = 0; i < rows; i++) {
+    for (S32 j = 0; j < columns; j++) {
+      const auto tag = tags[i * columns + j];
+      if (tag != NoTag) {
+        windows[tag].firstRow = std::min(windows[tag].firstRow, i);
+        windows[tag].firstColumn = std::min(windows[tag].firstColumn, j);
+        lastPositions[tag].i = static_cast<IndexType>(std::max<S32>(lastPositions[tag].i, i));
+        lastPositions[tag].j = static_cast<IndexType>(std::max<S32>(lastPositions[tag].j, j));
       }
     }
   }
-  const auto componentCount = currentTag;
-  const auto emptyRow = std::vector<std::optional<Tile>>(columnCount);
-  using TileMatrix = std::vector<std::vector<std::optional<Tile>>>;
-  const auto emptyTileMatrix = TileMatrix(rowCount, emptyRow);
-  auto tileMatrices = std::vector<TileMatrix>(componentCount, emptyTileMatrix);
-  for (S32 i = 0; i < rowCount; i++) {
-    for (S32 j = 0; j < columnCount; j++) {
-      if (tagMatrix[i][j] != NoTag) {
-        tileMatrices[tagMatrix[i][j]][i][j] = getTile(i, j);
+  auto tileVectors = std::vector<std::vector<std::optional<Tile>>>(componentCount);
+  for (TagType tag = 0; tag < componentCount; tag++) {
+    windows[tag].rowCount = lastPositions[tag].i - windows[tag].firstRow + 1;
+    windows[tag].columnCount = lastPositions[tag].j - windows[tag].firstColumn + 1;
+    tileVectors[tag].resize(static_cast<std::size_t>(windows[tag].rowCount) * windows[tag].columnCount);
+  }
+  for (S32 i = 0; i < rows; i++) {
+    for (S32 j = 0; j < columns; j++) {
+      const auto tag = tags[i * columns + j];
+      if (tag != NoTag) {
+        const auto &componentWindow = windows[tag];
+        const auto windowI = i - componentWindow.firstRow;
+        const auto windowJ = j - componentWindow.firstColumn;
+        tileVectors[tag][windowI * componentWindow.columnCount + windowJ] = tileAt(i, j);
       }
     }
   }
   auto components = std::vector<Board>{};
-  for (const auto &tileMatrix : tileMatrices) {
-    components.emplace_back(tileMatrix);
+  for (TagType tag = 0; tag < componentCount; tag++) {
+    components.push_back(Board(rows, columns, windows[tag], std::move(tileVectors[tag])));
   }
   return components;
 }
@@ -273,82 +390,100 @@ Board Board::mergeComponents(const std::vector<Board> &components) {
       }
     }
   }
-  Board merge(std::vector<std::vector<std::optional<Tile>>>(rowCount, std::vector<std::optional<Tile>>(columnCount)));
+  std::vector<std::optional<Tile>> tileVector(static_cast<std::size_t>(rowCount) * columnCount);
   for (const auto &component : components) {
     for (S32 i = 0; i < rowCount; i++) {
       for (S32 j = 0; j < columnCount; j++) {
         if (component.hasTile(i, j)) {
-          if (merge.hasTile(i, j)) {
-            const auto position = Position(i, j);
+          auto &tile = tileVector[i * columnCount + j];
+          if (tile) {
+            const auto position = Position(static_cast<IndexType>(i), static_cast<IndexType>(j));
             throw std::invalid_argument("Found two occurrences of tile " + position.toString() + ".");
-          } else {
-            merge.matrix[i][j] = component.matrix[i][j];
           }
+          tile = component.tileAt(i, j);
         }
       }
     }
   }
-  return merge;
+  return Board(rowCount, columnCount, std::move(tileVector));
 }
 
 std::string Board::toString() const {
-  const auto rowCount = getRowCount();
-  const auto columnCount = getColumnCount();
+  const auto rows = getRowCount();
+  const auto columns = getColumnCount();
   std::string board;
-  for (S32 i = 0; i < rowCount; i++) {
-    for (S32 j = 0; j < columnCount; j++) {
+  for (S32 i = 0; i < rows; i++) {
+    for (S32 j = 0; j < columns; j++) {
       if (hasTile(i, j)) {
-        board += matrix[i][j]->toString();
+        board += tileAt(i, j)->toString();
       } else {
         board += "  ";
       }
-      if (j + 1 < columnCount) {
+      if (j + 1 < columns) {
         board += ' ';
       }
     }
-    if (i + 1 < rowCount) {
+    if (i + 1 < rows) {
       board += '\n';
     }
   }
   return board;
 }
 
-Board Board::fromString(const std::string &string) {
+Board Board::fromString(std::string_view string) {
   if (string.empty()) {
     throw std::invalid_argument("Cannot create a board from an empty string.");
   }
-  std::vector<std::vector<std::optional<Tile>>> matrix(1);
-  auto atNextTile = true;
-  for (std::size_t i = 0; i < string.size(); i++) {
-    const auto character = string[i];
-    if (atNextTile) {
+  // Trailing line breaks do not add rows.
+  while (!string.empty() && (string.back() == '\n' || string.back() == '\r')) {
+    string.remove_suffix(1);
+  }
+  std::vector<std::optional<Tile>> tileVector;
+  S32 rows = 0;
+  S32 columns = 0;
+  while (true) {
+    const auto lineEnd = string.find('\n');
+    auto line = string.substr(0, lineEnd);
+    if (!line.empty() && line.back() == '\r') {
+      line.remove_suffix(1);
+    }
+    const auto rowBegin = tileVector.size();
+    std::size_t i = 0;
+    while (i < line.size()) {
+      const auto character = line[i];
       if (isalpha(character)) {
-        matrix.back().emplace_back(Tile(false, tileTypeFromCharacter(character)));
-        atNextTile = false;
-      } else if (character == ' ') {
-        matrix.back().push_back(std::nullopt);
-        atNextTile = false;
+        tileVector.emplace_back(Tile(false, tileTypeFromCharacter(character)));
         i++;
+        if (i < line.size() && isdigit(line[i])) {
+          tileVector.back()->up = line[i] == '1';
+          i++;
+        }
+      } else if (character == ' ') {
+        tileVector.emplace_back(std::nullopt);
+        i += 2;
       } else {
         throw std::invalid_argument("Found an unexpected start of tile: " + std::string(1, character) + ".");
       }
-    } else {
-      if (isdigit(character)) {
-        matrix.back().back()->up = character == '1';
-      } else if (character == '\n') {
-        matrix.emplace_back();
-        atNextTile = true;
-      } else if (character == ' ') {
-        atNextTile = true;
-      } else {
-        const auto message = "String has an invalid character: '" + std::string(1, character) + "'.";
-        throw std::invalid_argument(message);
+      if (i < line.size()) {
+        if (line[i] != ' ') {
+          const auto message = "String has an invalid character: '" + std::string(1, line[i]) + "'.";
+          throw std::invalid_argument(message);
+        }
+        i++;
       }
     }
+    const auto rowSize = static_cast<S32>(tileVector.size() - rowBegin);
+    if (rows == 0) {
+      columns = rowSize;
+    } else if (rowSize != columns) {
+      throw std::invalid_argument("Matrix is not rectangular.");
+    }
+    rows++;
+    if (lineEnd == std::string_view::npos) {
+      break;
+    }
+    string.remove_prefix(lineEnd + 1);
   }
-  while (matrix.back().empty()) {
-    matrix.pop_back();
-  }
-  return Board(matrix);
+  return Board(rows, columns, std::move(tileVector));
 }
 } // namespace WayoutPlayer
@@ -3,6 +3,7 @@
 #include <optional>
 #include <stdexcept>
 #include <string>
+#include <string_view>
 #include <utility>
 #include <vector>
 
@@ -18,9 +19,41 @@ public:
   std::optional<bool> twinFinalState;
 };
 
+/**
+ * The smallest rectangle of a board which holds all of its tiles.
+ */
+class TileWindow {
+public:
+  S32 firstRow = 0;
+  S32 firstColumn = 0;
+  S32 rowCount = 0;
+  S32 columnCount = 0;
+
+  [[nodiscard]] bool contains(S32 i, S32 j) const;
+};
+
 class Board {
-  std::vector<std::vector<std::optional<Tile>>> matrix;
-  bool startedWithBlockedTiles = false;
+  S32 rowCount = 0;
+  S32 columnCount = 0;
+  // Only the tiles in the window are stored, in row-major order, so that a component of a large board takes no more
+  // memory than the rectangle around it.
+  TileWindow window;
+  std::vector<std::optional<Tile>> tiles;
+  bool startedNeedingMultipleClicks = false;
+
+  /**
+   * Returns the tile at a position in the window.
+   */
+  std::optional<Tile> &tileAt(S32 i, S32 j);
+
+  /**
+   * Returns the tile at a position, which is empty outside the window.
+   */
+  [[nodiscard]] const std::optional<Tile> &tileAt(S32 i, S32 j) const;
+
+  Board(S32 rows, S32 columns, std::vector<std::optional<Tile>> tileVector);
+
+  Board(S32 rows, S32 columns, const TileWindow &tileWindow, std::vector<std::optional<Tile>> windowTiles);
 
 public:
   [[nodiscard]] S32 getRowCount() const;
@@ -39,9 +72,17 @@ public:
    */
   [[nodiscard]] bool canBeSolvedOptimallyDirectionally() const;
 
+  /**
+   * Returns whether or not the clicks on this board commute and are involutions.
+   *
+   * This holds when there are no blocked tiles and all twins are in the same state. The effect of a click then does not
+   * depend on the state of the board, so a solution is just a set of clicks.
+   */
+  [[nodiscard]] bool hasCommutativeClicks() const;
+
   void safeInvert(IndexType i, IndexType j, bool clicked, InversionHistory &history);
 
-  explicit Board(std::vector<std::vector<std::optional<Tile>>> tileMatrix);
+  explicit Board(const std::vector<std::vector<std::optional<Tile>>> &tileMatrix);
 
   [[nodiscard]] bool hasUnsolvedTilesAtRow(IndexType i) const;
 
@@ -72,6 +113,6 @@ public:
 
   [[nodiscard]] std::string toString() const;
 
-  static Board fromString(const std::string &string);
+  static Board fromString(std::string_view string);
 };
 } // namespace WayoutPlayer
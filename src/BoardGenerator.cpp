@@ -0,0 +1,109 @@
+#include "BoardGenerator.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <optional>
+#include <stdexcept>
+#include <string>
+
+namespace WayoutPlayer {
+namespace {
+// Most specifications give a solvable board within a few attempts, so running out of them means one never will.
+constexpr U32 MaximumAttempts = 1000;
+
+/**
+ * Clicks the tiles in order, returning false without finishing if one of them is blocked.
+ */
+bool replay(Board &board, const std::vector<Position> &clicks) {
+  for (const auto &position : clicks) {
+    if (board.getTile(position.i, position.j).type == TileType::Blocked) {
+      return false;
+    }
+    board.activate(position.i, position.j);
+  }
+  return true;
+}
+} // namespace
+
+BoardGenerator::BoardGenerator(U64 seed) : generator(seed) {
+}
+
+GeneratedBoard BoardGenerator::generate(const BoardSpecification &specification) {
+  const auto maximumSide = static_cast<S32>(std::numeric_limits<IndexType>::max());
+  if (specification.rowCount <= 0 || specification.rowCount > maximumSide || specification.columnCount <= 0 ||
+      specification.columnCount > maximumSide) {
+    const auto limitString = std::to_string(maximumSide);
+    throw std::invalid_argument("Board should have between 1 and " + limitString + " rows and columns.");
+  }
+  if (!(specification.density > 0.0 && specification.density <= 1.0)) {
+    throw std::invalid_argument("Density should be more than 0 and at most 1.");
+  }
+  if (specification.typeMix.empty()) {
+    throw std::invalid_argument("Type mix should have at least one tile type.");
+  }
+  std::vector<TileType> types;
+  for (const auto character : specification.typeMix) {
+    types.push_back(tileTypeFromCharacter(character));
+  }
+  std::uniform_real_distribution<F64> uniform(0.0, 1.0);
+  for (U32 attempt = 0; attempt < MaximumAttempts; attempt++) {
+    using TileMatrix = std::vector<std::vector<std::optional<Tile>>>;
+    TileMatrix matrix(specification.rowCount, std::vector<std::optional<Tile>>(specification.columnCount));
+    std::vector<Position> clickablePositions;
+    std::vector<Position> blockedPositions;
+    for (S32 i = 0; i < specification.rowCount; i++) {
+      for (S32 j = 0; j < specification.columnCount; j++) {
+        if (uniform(generator) >= specification.density) {
+          continue;
+        }
+        const auto type = types[generator() % types.size()];
+        const Position position(static_cast<IndexType>(i), static_cast<IndexType>(j));
+        if (type == TileType::Blocked) {
+          matrix[i][j] = Tile(false, TileType::Default);
+          blockedPositions.push_back(position);
+        } else {
+          matrix[i][j] = Tile(false, type);
+          clickablePositions.push_back(position);
+        }
+      }
+    }
+    if (clickablePositions.empty()) {
+      continue;
+    }
+    Board scrambledBoard(matrix);
+    std::vector<Position> clicks;
+    for (U32 click = 0; click < specification.clickCount; click++) {
+      const auto position = clickablePositions[generator() % clickablePositions.size()];
+      scrambledBoard.activate(position.i, position.j);
+      clicks.push_back(position);
+    }
+    std::reverse(std::begin(clicks), std::end(clicks));
+    for (S32 i = 0; i < specification.rowCount; i++) {
+      for (S32 j = 0; j < specification.columnCount; j++) {
+        if (matrix[i][j]) {
+          matrix[i][j] = scrambledBoard.getTile(i, j);
+        }
+      }
+    }
+    for (const auto &position : blockedPositions) {
+      matrix[position.i][position.j]->type = TileType::Blocked;
+    }
+    auto replayedBoard = Board(matrix);
+    if (!replay(replayedBoard, clicks)) {
+      continue;
+    }
+    // A blocked tile ignores the first change made by its neighbors, so one left raised must start in the other state.
+    for (const auto &position : blockedPositions) {
+      if (replayedBoard.getTile(position.i, position.j).up) {
+        matrix[position.i][position.j]->up = !matrix[position.i][position.j]->up;
+      }
+    }
+    const Board board(matrix);
+    replayedBoard = board;
+    if (replay(replayedBoard, clicks) && replayedBoard.isSolved()) {
+      return GeneratedBoard{board, clicks};
+    }
+  }
+  throw std::runtime_error("Could not generate a solvable board for the specification.");
+}
+} // namespace WayoutPlayer
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <random>
+#include <string>
+#include <vector>
+
+#include "Board.hpp"
+#include "Position.hpp"
+#include "Types.hpp"
+
+namespace WayoutPlayer {
+/**
+ * What kind of boards a BoardGenerator makes.
+ */
+class BoardSpecification {
+public:
+  S32 rowCount = 4;
+  S32 columnCount = 4;
+  // The probability that a cell has a tile.
+  F64 density = 1.0;
+  // The character of a tile type appears in the mix once for every time it should be drawn, as in "DDDHV".
+  std::string typeMix = "D";
+  U32 clickCount = 4;
+};
+
+class GeneratedBoard {
+public:
+  Board board;
+  // Clicks which solve the board, which are not necessarily the fewest.
+  std::vector<Position> clicks;
+};
+
+/**
+ * Makes random boards which are known to be solvable, and makes the same boards again when given the same seed.
+ *
+ * Boards are made by clicking random tiles of a solved board. Blocked tiles are treated as Default tiles while clicking,
+ * and their states are then chosen so that replaying the clicks in reverse solves the board. Boards on which that fails,
+ * for instance because Twin tiles do not return to their previous states, are discarded and drawn again.
+ */
+class BoardGenerator {
+  std::mt19937_64 generator;
+
+public:
+  explicit BoardGenerator(U64 seed);
+
+  GeneratedBoard generate(const BoardSpecification &specification);
+};
+} // namespace WayoutPlayer
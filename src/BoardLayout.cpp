@@ -0,0 +1,160 @@
+#include "BoardLayout.hpp"
+
+#include <bit>
+#include <stdexcept>
+
+namespace WayoutPlayer {
+BoardLayout::BoardLayout(const Board &board) : rowCount(board.getRowCount()), columnCount(board.getColumnCount()) {
+  indexMatrix.resize(rowCount * columnCount, -1);
+  for (S32 i = 0; i < rowCount; i++) {
+    for (S32 j = 0; j < columnCount; j++) {
+      if (board.hasTile(i, j)) {
+        indexMatrix[i * columnCount + j] = static_cast<S32>(positions.size());
+        positions.emplace_back(i, j);
+        types.push_back(board.getTile(i, j).type);
+      }
+    }
+  }
+  for (S32 index = 0; index < getTileCount(); index++) {
+    const auto position = positions[index];
+    const auto neighborIndex = [this](S32 i, S32 j) { return getIndex(i, j).value_or(-1); };
+    neighbors.push_back({neighborIndex(position.i - 1, position.j), neighborIndex(position.i, position.j - 1),
+                         neighborIndex(position.i, position.j + 1), neighborIndex(position.i + 1, position.j)});
+    if (types[index] == TileType::Twin && index < MaximumPackedTileCount) {
+      twinMask |= U64{1} << static_cast<U32>(index);
+    }
+  }
+}
+
+S32 BoardLayout::getRowCount() const {
+  return rowCount;
+}
+
+S32 BoardLayout::getColumnCount() const {
+  return columnCount;
+}
+
+S32 BoardLayout::getTileCount() const {
+  return static_cast<S32>(positions.size());
+}
+
+bool BoardLayout::canBePacked() const {
+  return getTileCount() <= MaximumPackedTileCount;
+}
+
+std::optional<S32> BoardLayout::getIndex(S32 i, S32 j) const {
+  if (i < 0 || i >= rowCount || j < 0 || j >= columnCount) {
+    return std::nullopt;
+  }
+  const auto index = indexMatrix[i * columnCount + j];
+  if (index < 0) {
+    return std::nullopt;
+  }
+  return index;
+}
+
+Position BoardLayout::getPosition(S32 index) const {
+  return positions[index];
+}
+
+TileType BoardLayout::getType(S32 index) const {
+  return types[index];
+}
+
+const std::array<S32, 4> &BoardLayout::getNeighbors(S32 index) const {
+  return neighbors[index];
+}
+
+U64 BoardLayout::getTwinMask() const {
+  return twinMask;
+}
+
+U64 BoardLayout::getUpMask(const Board &board) const {
+  if (!canBePacked()) {
+    throw std::invalid_argument("Board has too many tiles to be packed.");
+  }
+  U64 mask = 0;
+  for (S32 index = 0; index < getTileCount(); index++) {
+    const auto position = positions[index];
+    if (board.getTile(position.i, position.j).up) {
+      mask |= U64{1} << static_cast<U32>(index);
+    }
+  }
+  return mask;
+}
+
+U64 BoardLayout::getBlockedMask(const Board &board) const {
+  if (!canBePacked()) {
+    throw std::invalid_argument("Board has too many tiles to be packed.");
+  }
+  U64 mask = 0;
+  for (S32 index = 0; index < getTileCount(); index++) {
+    const auto position = positions[index];
+    if (board.getTile(position.i, position.j).type == TileType::Blocked) {
+      mask |= U64{1} << static_cast<U32>(index);
+    }
+  }
+  return mask;
+}
+
+std::vector<S32> BoardLayout::findRaisedTaps(U64 upMask) const {
+  std::vector<S32> raisedTaps;
+  for (S32 index = 0; index < getTileCount(); index++) {
+    if (types[index] == TileType::Tap && (upMask & (U64{1} << static_cast<U32>(index))) != 0) {
+      raisedTaps.push_back(index);
+    }
+  }
+  return raisedTaps;
+}
+
+std::vector<U64> BoardLayout::computeClickEffects(const Board &board) const {
+  const auto initialMask = getUpMask(board);
+  std::vector<U64> effects;
+  effects.reserve(positions.size());
+  for (const auto position : positions) {
+    auto derivedBoard = board;
+    derivedBoard.activate(position.i, position.j);
+    effects.push_back(getUpMask(derivedBoard) ^ initialMask);
+  }
+  return effects;
+}
+
+std::vector<U64> BoardLayout::computeClickReaches() const {
+  if (!canBePacked()) {
+    throw std::invalid_argument("Board has too many tiles to be packed.");
+  }
+  U64 chainMask = 0;
+  for (S32 index = 0; index < getTileCount(); index++) {
+    if (types[index] == TileType::Chain) {
+      chainMask |= U64{1} << static_cast<U32>(index);
+    }
+  }
+  std::vector<U64> reaches;
+  reaches.reserve(positions.size());
+  for (S32 index = 0; index < getTileCount(); index++) {
+    const auto bit = U64{1} << static_cast<U32>(index);
+    U64 reach = bit;
+    const auto reachNeighbors = [this, &reach](S32 tile, bool horizontal, bool vertical) {
+      for (S32 k = 0; k < 4; k++) {
+        const auto isHorizontal = k == 1 || k == 2;
+        if (neighbors[tile][k] >= 0 && (isHorizontal ? horizontal : vertical)) {
+          reach |= U64{1} << static_cast<U32>(neighbors[tile][k]);
+        }
+      }
+    };
+    reachNeighbors(index, types[index] != TileType::Vertical, types[index] != TileType::Horizontal);
+    // A clicked chain acts as a default tile, but every other chain that is reached inverts all of its neighbors.
+    U64 expandedChains = bit;
+    for (auto chains = reach & chainMask & ~expandedChains; chains != 0; chains = reach & chainMask & ~expandedChains) {
+      const auto chain = std::countr_zero(chains);
+      expandedChains |= U64{1} << static_cast<U32>(chain);
+      reachNeighbors(chain, true, true);
+    }
+    if ((reach & twinMask) != 0) {
+      reach |= twinMask;
+    }
+    reaches.push_back(reach);
+  }
+  return reaches;
+}
+} // namespace WayoutPlayer
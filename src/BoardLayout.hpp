@@ -0,0 +1,90 @@
+#pragma once
+
+#include <array>
+#include <optional>
+#include <vector>
+
+#include "Board.hpp"
+#include "Position.hpp"
+#include "TileType.hpp"
+#include "Types.hpp"
+
+namespace WayoutPlayer {
+/**
+ * Assigns consecutive indices to the tiles of a board in row-major order.
+ *
+ * Packed representations of a board use these indices as bit positions.
+ */
+class BoardLayout {
+  S32 rowCount = 0;
+  S32 columnCount = 0;
+  std::vector<S32> indexMatrix;
+  std::vector<Position> positions;
+  std::vector<TileType> types;
+  // The indices of the neighbors above, to the left, to the right and below each tile, or -1.
+  std::vector<std::array<S32, 4>> neighbors;
+  U64 twinMask = 0;
+
+public:
+  static constexpr S32 MaximumPackedTileCount = 64;
+
+  explicit BoardLayout(const Board &board);
+
+  [[nodiscard]] S32 getRowCount() const;
+
+  [[nodiscard]] S32 getColumnCount() const;
+
+  [[nodiscard]] S32 getTileCount() const;
+
+  [[nodiscard]] bool canBePacked() const;
+
+  [[nodiscard]] std::optional<S32> getIndex(S32 i, S32 j) const;
+
+  [[nodiscard]] Position getPosition(S32 index) const;
+
+  /**
+   * Returns the type the tile had when the layout was created.
+   */
+  [[nodiscard]] TileType getType(S32 index) const;
+
+  /**
+   * Returns the indices of the neighbors above, to the left, to the right and below the tile, or -1 where there are
+   * none.
+   */
+  [[nodiscard]] const std::array<S32, 4> &getNeighbors(S32 index) const;
+
+  [[nodiscard]] U64 getTwinMask() const;
+
+  /**
+   * Returns a mask with the bits of the raised tiles of the board set.
+   */
+  [[nodiscard]] U64 getUpMask(const Board &board) const;
+
+  /**
+   * Returns a mask with the bits of the blocked tiles of the board set.
+   */
+  [[nodiscard]] U64 getBlockedMask(const Board &board) const;
+
+  /**
+   * Returns the indices of the raised taps among the raised tiles of the mask, in increasing order.
+   *
+   * Raised taps can only be lowered by clicking them, and lowered taps would be raised by clicking them, so every
+   * solution clicks each raised tap once and no other tap. Engines make these clicks before anything else and leave
+   * taps out of their search.
+   */
+  [[nodiscard]] std::vector<S32> findRaisedTaps(U64 upMask) const;
+
+  /**
+   * Returns, for every tile, the mask of tiles which are inverted by clicking it.
+   *
+   * This is only meaningful for boards with commutative clicks, on which the effect of a click does not depend on the
+   * state of the board.
+   */
+  [[nodiscard]] std::vector<U64> computeClickEffects(const Board &board) const;
+
+  /**
+   * Returns, for every tile, a mask of the tiles which clicking it may invert or unblock on any board with this layout.
+   */
+  [[nodiscard]] std::vector<U64> computeClickReaches() const;
+};
+} // namespace WayoutPlayer
@@ -0,0 +1,62 @@
+#include "BoardReader.hpp"
+
+namespace WayoutPlayer {
+namespace {
+constexpr char HeaderPrefix = '#';
+
+std::string_view removeLine(std::string_view &text) {
+  const auto lineEnd = text.find('\n');
+  auto line = text.substr(0, lineEnd);
+  text.remove_prefix(lineEnd == std::string_view::npos ? text.size() : lineEnd + 1);
+  if (!line.empty() && line.back() == '\r') {
+    line.remove_suffix(1);
+  }
+  return line;
+}
+
+std::string_view trim(std::string_view text) {
+  while (!text.empty() && text.front() == ' ') {
+    text.remove_prefix(1);
+  }
+  while (!text.empty() && text.back() == ' ') {
+    text.remove_suffix(1);
+  }
+  return text;
+}
+} // namespace
+
+BoardReader::BoardReader(std::string_view text) : remaining(text) {
+}
+
+std::optional<BoardRecord> BoardReader::next() {
+  std::string name;
+  // Skip separators, keeping the name of the last header.
+  while (!remaining.empty()) {
+    auto lookahead = remaining;
+    const auto line = removeLine(lookahead);
+    if (line.empty()) {
+      remaining = lookahead;
+    } else if (line.front() == HeaderPrefix) {
+      name = trim(line.substr(1));
+      remaining = lookahead;
+    } else {
+      break;
+    }
+  }
+  if (remaining.empty()) {
+    return std::nullopt;
+  }
+  const auto begin = remaining.data();
+  auto end = begin;
+  while (!remaining.empty()) {
+    auto lookahead = remaining;
+    const auto line = removeLine(lookahead);
+    if (line.empty() || line.front() == HeaderPrefix) {
+      break;
+    }
+    end = line.data() + line.size();
+    remaining = lookahead;
+  }
+  return BoardRecord{name, Board::fromString(std::string_view(begin, end - begin))};
+}
+} // namespace WayoutPlayer
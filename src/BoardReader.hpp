@@ -0,0 +1,36 @@
+#pragma once
+
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include "Board.hpp"
+
+namespace WayoutPlayer {
+class BoardRecord {
+public:
+  // The text of the header line which preceded the board, if any, without the leading '#'.
+  std::string name;
+  Board board;
+};
+
+/**
+ * Reads a stream of boards from text without copying it.
+ *
+ * Boards use the usual text format and are separated by empty lines or by header lines starting with '#'. A header
+ * line names the board that follows it. A single board without headers is also a valid stream.
+ *
+ * Boards are only parsed when they are requested, so a large stream can be consumed one board at a time.
+ */
+class BoardReader {
+  std::string_view remaining;
+
+public:
+  explicit BoardReader(std::string_view text);
+
+  /**
+   * Parses and returns the next board, or nothing if the stream has no more boards.
+   */
+  std::optional<BoardRecord> next();
+};
+} // namespace WayoutPlayer
@@ -0,0 +1,252 @@
+#include "ChasingEngine.hpp"
+
+#include <bit>
+#include <optional>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "BitPlane.hpp"
+
+namespace WayoutPlayer {
+namespace {
+// Beyond this many sets of clicks without effect, the lightest solution is only approached greedily.
+constexpr std::size_t MaximumEnumeratedNullity = 20;
+// Beyond this many, finding the clicks each of them toggles costs more than the clicks they could save.
+constexpr std::size_t MaximumImprovedNullity = 64;
+
+/**
+ * Returns whether or not clicking the tile at the first position changes the tile at the second position.
+ */
+bool reaches(const Board &board, S32 i, S32 j, S32 targetI, S32 targetJ) {
+  if (!board.hasTile(i, j) || !board.hasTile(targetI, targetJ)) {
+    return false;
+  }
+  if (i == targetI && j == targetJ) {
+    return true;
+  }
+  // Taps only change when they are clicked.
+  if (board.getTile(targetI, targetJ).type == TileType::Tap) {
+    return false;
+  }
+  const auto type = board.getTile(i, j).type;
+  if (i != targetI) {
+    return type == TileType::Default || type == TileType::Tap || type == TileType::Vertical;
+  }
+  return type == TileType::Default || type == TileType::Tap || type == TileType::Horizontal;
+}
+
+/**
+ * A system over GF(2) reduced to row echelon form, whose equations have the right-hand side as their last bit.
+ */
+class ReducedSystem {
+public:
+  // The solution with every unknown which is not a pivot cleared.
+  BitPlane particularSolution;
+  // Solutions of the homogeneous system such that every solution is the particular one plus a sum of some of them.
+  std::vector<BitPlane> nullSpaceBasis;
+};
+
+std::optional<ReducedSystem> reduceSystem(std::vector<BitPlane> equations, std::size_t unknownCount) {
+  std::vector<std::optional<std::size_t>> pivotRows(unknownCount);
+  std::size_t rank = 0;
+  for (std::size_t unknown = 0; unknown < unknownCount && rank < equations.size(); unknown++) {
+    auto pivot = rank;
+    while (pivot < equations.size() && !equations[pivot].test(unknown)) {
+      pivot++;
+    }
+    if (pivot == equations.size()) {
+      continue;
+    }
+    std::swap(equations[rank], equations[pivot]);
+    for (std::size_t row = 0; row < equations.size(); row++) {
+      if (row != rank && equations[row].test(unknown)) {
+        equations[row] ^= equations[rank];
+      }
+    }
+    pivotRows[unknown] = rank;
+    rank++;
+  }
+  // Every equation left without unknowns must have a cleared right-hand side.
+  for (auto row = rank; row < equations.size(); row++) {
+    if (equations[row].test(unknownCount)) {
+      return std::nullopt;
+    }
+  }
+  ReducedSystem system;
+  system.particularSolution = BitPlane(unknownCount);
+  for (std::size_t unknown = 0; unknown < unknownCount; unknown++) {
+    if (pivotRows[unknown]) {
+      if (equations[*pivotRows[unknown]].test(unknownCount)) {
+        system.particularSolution.set(unknown);
+      }
+      continue;
+    }
+    BitPlane basisVector(unknownCount);
+    basisVector.set(unknown);
+    for (std::size_t pivotUnknown = 0; pivotUnknown < unknown; pivotUnknown++) {
+      if (pivotRows[pivotUnknown] && equations[*pivotRows[pivotUnknown]].test(unknown)) {
+        basisVector.set(pivotUnknown);
+      }
+    }
+    system.nullSpaceBasis.push_back(std::move(basisVector));
+  }
+  return system;
+}
+} // namespace
+
+ChasingEngine::ChasingEngine(const SolverConfiguration &configuration) : solverConfiguration(configuration) {
+}
+
+bool ChasingEngine::canSolve(const Board &board) const {
+  for (S32 i = 0; i < board.getRowCount(); i++) {
+    for (S32 j = 0; j < board.getColumnCount(); j++) {
+      if (board.hasTile(i, j)) {
+        const auto type = board.getTile(i, j).type;
+        if (type == TileType::Blocked || type == TileType::Chain || type == TileType::Twin) {
+          return false;
+        }
+      }
+    }
+  }
+  return true;
+}
+
+Solution ChasingEngine::findSolution(const Board &board) const {
+  if (!canSolve(board)) {
+    throw std::invalid_argument("Chasing supports boards of Default, Horizontal, Vertical and Tap tiles.");
+  }
+  const auto rowCount = board.getRowCount();
+  const auto columnCount = board.getColumnCount();
+  std::vector<Position> positions;
+  // The index of every tile in row-major order among the tiles, or -1 where there is no tile.
+  std::vector<S32> tileIndices(static_cast<std::size_t>(rowCount) * static_cast<std::size_t>(columnCount), -1);
+  for (S32 i = 0; i < rowCount; i++) {
+    for (S32 j = 0; j < columnCount; j++) {
+      if (board.hasTile(i, j)) {
+        tileIndices[i * columnCount + j] = static_cast<S32>(positions.size());
+        positions.emplace_back(static_cast<IndexType>(i), static_cast<IndexType>(j));
+      }
+    }
+  }
+  // The tile each click chases, if any, which is a tile whose last click in row-major order it is.
+  std::vector<S32> chasedTiles;
+  std::size_t unknownCount = 0;
+  for (const auto &position : positions) {
+    const S32 i = position.i;
+    const S32 j = position.j;
+    auto chasedTile = -1;
+    if (reaches(board, i, j, i - 1, j)) {
+      chasedTile = tileIndices[(i - 1) * columnCount + j];
+    } else if (reaches(board, i, j, i, j - 1) && !reaches(board, i + 1, j - 1, i, j - 1)) {
+      chasedTile = tileIndices[i * columnCount + j - 1];
+    } else if (!reaches(board, i, j + 1, i, j) && !reaches(board, i + 1, j, i, j)) {
+      chasedTile = tileIndices[i * columnCount + j];
+    }
+    chasedTiles.push_back(chasedTile);
+    unknownCount += chasedTile < 0 ? 1 : 0;
+  }
+  // Every tile and every click is a linear combination of the unknowns, with the constant term as the last bit.
+  const auto formSize = unknownCount + 1;
+  std::vector<BitPlane> tileForms;
+  tileForms.reserve(positions.size());
+  for (const auto &position : positions) {
+    tileForms.emplace_back(formSize);
+    if (board.getTile(position.i, position.j).up) {
+      tileForms.back().set(unknownCount);
+    }
+  }
+  std::vector<BitPlane> clickForms;
+  clickForms.reserve(positions.size());
+  std::size_t nextUnknown = 0;
+  for (std::size_t index = 0; index < positions.size(); index++) {
+    const S32 i = positions[index].i;
+    const S32 j = positions[index].j;
+    if (chasedTiles[index] >= 0) {
+      // No later click reaches the chased tile, so it is lowered exactly when it is raised, which clears its form.
+      clickForms.push_back(tileForms[chasedTiles[index]]);
+    } else {
+      clickForms.emplace_back(formSize);
+      clickForms.back().set(nextUnknown++);
+    }
+    for (const auto &[targetI, targetJ] : {std::pair{i, j}, std::pair{i - 1, j}, std::pair{i, j - 1},
+                                          std::pair{i, j + 1}, std::pair{i + 1, j}}) {
+      if (reaches(board, i, j, targetI, targetJ)) {
+        tileForms[tileIndices[targetI * columnCount + targetJ]] ^= clickForms.back();
+      }
+    }
+  }
+  std::vector<BitPlane> equations;
+  for (auto &tileForm : tileForms) {
+    if (!tileForm.isZero()) {
+      equations.push_back(std::move(tileForm));
+    }
+  }
+  const auto system = reduceSystem(std::move(equations), unknownCount);
+  if (!system) {
+    throw std::runtime_error("Cannot be solved, as the tiles left after chasing cannot all be lowered.");
+  }
+  // The clicks made by a solution of the system, and the clicks each vector of the null space basis toggles.
+  const auto evaluate = [&clickForms, unknownCount](const BitPlane &unknowns, bool withConstants) {
+    BitPlane clicks(clickForms.size());
+    auto extendedUnknowns = BitPlane(unknownCount + 1);
+    for (auto unknown = unknowns.findNext(0); unknown < unknownCount; unknown = unknowns.findNext(unknown + 1)) {
+      extendedUnknowns.set(unknown);
+    }
+    if (withConstants) {
+      extendedUnknowns.set(unknownCount);
+    }
+    for (std::size_t index = 0; index < clickForms.size(); index++) {
+      if (clickForms[index].dot(extendedUnknowns)) {
+        clicks.set(index);
+      }
+    }
+    return clicks;
+  };
+  auto clicks = evaluate(system->particularSolution, true);
+  std::vector<BitPlane> toggles;
+  if (system->nullSpaceBasis.size() <= MaximumImprovedNullity) {
+    for (const auto &basisVector : system->nullSpaceBasis) {
+      toggles.push_back(evaluate(basisVector, false));
+    }
+  }
+  const auto optimal = system->nullSpaceBasis.size() <= MaximumEnumeratedNullity;
+  U64 exploredNodes = 1;
+  if (optimal) {
+    // Every solution is visited in Gray code order, so that moving to the next one toggles a single basis vector.
+    auto current = clicks;
+    auto bestCount = clicks.count();
+    for (U64 step = 1; step < U64{1} << toggles.size(); step++) {
+      current ^= toggles[static_cast<std::size_t>(std::countr_zero(step))];
+      const auto currentCount = current.count();
+      if (currentCount < bestCount) {
+        clicks = current;
+        bestCount = currentCount;
+      }
+      exploredNodes++;
+    }
+  } else {
+    // Basis vectors are applied while any of them saves clicks, which reaches a solution no single one improves.
+    auto improved = true;
+    while (improved) {
+      improved = false;
+      for (const auto &toggle : toggles) {
+        auto candidate = clicks;
+        candidate ^= toggle;
+        exploredNodes++;
+        if (candidate.count() < clicks.count()) {
+          clicks = std::move(candidate);
+          improved = true;
+        }
+      }
+    }
+  }
+  std::vector<Position> clickPositions;
+  for (auto index = clicks.findNext(0); index < clicks.getSize(); index = clicks.findNext(index + 1)) {
+    clickPositions.push_back(positions[index]);
+  }
+  Solution solution(clickPositions, optimal);
+  solution.setExploredNodes(exploredNodes);
+  return solution;
+}
+} // namespace WayoutPlayer
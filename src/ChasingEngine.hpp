@@ -0,0 +1,32 @@
+#pragma once
+
+#include "Board.hpp"
+#include "Solution.hpp"
+#include "SolverConfiguration.hpp"
+
+namespace WayoutPlayer {
+/**
+ * Finds minimum solutions for boards of any size whose clicks only reach their own tile and its four neighbors, which
+ * are boards of Default, Horizontal, Vertical and Tap tiles.
+ *
+ * Clicks on such boards commute, so a solution is a set of clicks. Going through the clicks in row-major order, a click
+ * which is the last one to reach some tile is the only click left that can lower it, so it is decided by that tile, as
+ * the click below a raised tile is in light chasing. Only the other clicks become unknowns. The clicks are carried as
+ * linear combinations of the unknowns in bit planes, and the tiles they leave give a system over GF(2) with about as
+ * many unknowns as the board has columns, whose solutions are enumerated for the one with the fewest clicks while
+ * there are few enough of them.
+ */
+class ChasingEngine {
+  const SolverConfiguration &solverConfiguration;
+
+public:
+  explicit ChasingEngine(const SolverConfiguration &configuration);
+
+  /**
+   * Returns whether or not this engine can solve the board.
+   */
+  [[nodiscard]] bool canSolve(const Board &board) const;
+
+  [[nodiscard]] Solution findSolution(const Board &board) const;
+};
+} // namespace WayoutPlayer
@@ -0,0 +1,106 @@
+#include "ComponentCache.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <utility>
+
+namespace WayoutPlayer {
+NormalizedComponent NormalizedComponent::fromBoard(const Board &component, const SolverConfiguration &configuration) {
+  auto minimumI = std::numeric_limits<S32>::max();
+  auto minimumJ = std::numeric_limits<S32>::max();
+  auto maximumI = std::numeric_limits<S32>::min();
+  auto maximumJ = std::numeric_limits<S32>::min();
+  for (S32 i = 0; i < component.getRowCount(); i++) {
+    for (S32 j = 0; j < component.getColumnCount(); j++) {
+      if (component.hasTile(i, j)) {
+        minimumI = std::min(minimumI, i);
+        minimumJ = std::min(minimumJ, j);
+        maximumI = std::max(maximumI, i);
+        maximumJ = std::max(maximumJ, j);
+      }
+    }
+  }
+  NormalizedComponent normalizedComponent;
+  if (minimumI > maximumI) {
+    return normalizedComponent;
+  }
+  normalizedComponent.origin = Position(static_cast<IndexType>(minimumI), static_cast<IndexType>(minimumJ));
+  auto &key = normalizedComponent.key;
+  key.push_back(static_cast<char>(configuration.getEngine()));
+  key.push_back(static_cast<char>(configuration.isFlippingOnlyUp()));
+  // The height and the width take two bytes each, as boards may have more than 255 rows and columns.
+  for (const auto side : {maximumI - minimumI + 1, maximumJ - minimumJ + 1}) {
+    key.push_back(static_cast<char>(side & 0xff));
+    key.push_back(static_cast<char>(side >> 8));
+  }
+  // Every cell takes a byte: zero if it has no tile, and otherwise one more than the type and the state of its tile.
+  for (S32 i = minimumI; i <= maximumI; i++) {
+    for (S32 j = minimumJ; j <= maximumJ; j++) {
+      if (component.hasTile(i, j)) {
+        const auto tile = component.getTile(i, j);
+        key.push_back(static_cast<char>(1 + (tileTypeToInteger(tile.type) << 1u | static_cast<U32>(tile.up))));
+      } else {
+        key.push_back(0);
+      }
+    }
+  }
+  return normalizedComponent;
+}
+
+std::size_t ComponentCache::estimateBytes(const Entry &entry) {
+  // A list node, a hash table node and its bucket, besides the entry itself.
+  const auto overhead = 6 * sizeof(void *) + sizeof(std::string_view);
+  return overhead + sizeof(Entry) + entry.key.capacity() + entry.clicks.capacity() * sizeof(Position);
+}
+
+std::optional<std::vector<Position>> ComponentCache::find(const NormalizedComponent &component) {
+  std::scoped_lock lock(mutex);
+  const auto iterator = entryIndex.find(component.key);
+  if (iterator == std::end(entryIndex)) {
+    return std::nullopt;
+  }
+  entries.splice(std::begin(entries), entries, iterator->second);
+  auto clicks = iterator->second->clicks;
+  for (auto &click : clicks) {
+    click.i = static_cast<IndexType>(click.i + component.origin.i);
+    click.j = static_cast<IndexType>(click.j + component.origin.j);
+  }
+  return clicks;
+}
+
+void ComponentCache::insert(const NormalizedComponent &component, const std::vector<Position> &clicks,
+                            std::size_t budgetInBytes) {
+  Entry entry{component.key, clicks};
+  entry.key.shrink_to_fit();
+  for (auto &click : entry.clicks) {
+    click.i = static_cast<IndexType>(click.i - component.origin.i);
+    click.j = static_cast<IndexType>(click.j - component.origin.j);
+  }
+  const auto entryBytes = estimateBytes(entry);
+  if (entryBytes > budgetInBytes) {
+    return;
+  }
+  std::scoped_lock lock(mutex);
+  if (entryIndex.contains(entry.key)) {
+    return;
+  }
+  while (sizeInBytes + entryBytes > budgetInBytes) {
+    sizeInBytes -= estimateBytes(entries.back());
+    entryIndex.erase(entries.back().key);
+    entries.pop_back();
+  }
+  entries.push_front(std::move(entry));
+  entryIndex.emplace(entries.front().key, std::begin(entries));
+  sizeInBytes += entryBytes;
+}
+
+std::size_t ComponentCache::getSize() const {
+  std::scoped_lock lock(mutex);
+  return entries.size();
+}
+
+std::size_t ComponentCache::getSizeInBytes() const {
+  std::scoped_lock lock(mutex);
+  return sizeInBytes;
+}
+} // namespace WayoutPlayer
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <list>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "Board.hpp"
+#include "Position.hpp"
+#include "SolverConfiguration.hpp"
+#include "Types.hpp"
+
+namespace WayoutPlayer {
+/**
+ * A component cropped to its bounding box, identified by a key which is the same wherever the component lies.
+ */
+class NormalizedComponent {
+public:
+  std::string key;
+  // The top left corner of the bounding box of the component on its board.
+  Position origin{0, 0};
+
+  /**
+   * Normalizes a component to be solved with the configuration, as only configurations which find the same solutions
+   * share keys.
+   */
+  static NormalizedComponent fromBoard(const Board &component, const SolverConfiguration &configuration);
+};
+
+/**
+ * Remembers the clicks of the most recently solved components relative to their bounding boxes, so that components
+ * which appear again, in the same board or in another one and at any offset, are not searched again.
+ *
+ * The least recently used components are forgotten to stay within a budget of bytes. Safe to use from many threads.
+ */
+class ComponentCache {
+  class Entry {
+  public:
+    std::string key;
+    std::vector<Position> clicks;
+  };
+
+  // The most recently used entries come first.
+  std::list<Entry> entries;
+  std::unordered_map<std::string_view, std::list<Entry>::iterator> entryIndex;
+  std::size_t sizeInBytes = 0;
+  mutable std::mutex mutex;
+
+  static std::size_t estimateBytes(const Entry &entry);
+
+public:
+  /**
+   * Returns the clicks which solve the component, translated to where it lies, if it is remembered.
+   */
+  [[nodiscard]] std::optional<std::vector<Position>> find(const NormalizedComponent &component);
+
+  /**
+   * Remembers the clicks which solve the component, forgetting other components until the cache fits the budget.
+   */
+  void insert(const NormalizedComponent &component, const std::vector<Position> &clicks, std::size_t budgetInBytes);
+
+  [[nodiscard]] std::size_t getSize() const;
+
+  [[nodiscard]] std::size_t getSizeInBytes() const;
+};
+} // namespace WayoutPlayer
@@ -0,0 +1,185 @@
+#include "Corpus.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+#include "Bits.hpp"
+
+namespace WayoutPlayer {
+namespace {
+constexpr std::string_view Magic = "WOPCORPS";
+constexpr std::string_view FormatName = "Corpus";
+constexpr U32 Version = 1;
+constexpr std::size_t HeaderSize = Magic.size() + 2 * sizeof(U32);
+constexpr std::size_t IndexRecordSize = Digest().size() + 2 * sizeof(U64);
+constexpr std::size_t PlaneCount = 5;
+
+std::size_t getPlaneSize(std::size_t rows, std::size_t columns) {
+  return (rows * columns + 7) / 8;
+}
+
+void writeBoard(std::string &bytes, const Board &board) {
+  const auto rows = board.getRowCount();
+  const auto columns = board.getColumnCount();
+  writeInteger<U16>(bytes, rows);
+  writeInteger<U16>(bytes, columns);
+  const auto planeSize = getPlaneSize(rows, columns);
+  std::vector<std::string> planes(PlaneCount, std::string(planeSize, '\0'));
+  for (S32 i = 0; i < rows; i++) {
+    for (S32 j = 0; j < columns; j++) {
+      if (!board.hasTile(i, j)) {
+        continue;
+      }
+      const auto tile = board.getTile(i, j);
+      const auto bit = static_cast<std::size_t>(i * columns + j);
+      const auto type = tileTypeToInteger(tile.type);
+      const std::array<bool, PlaneCount> values = {true, tile.up, (type & 1u) != 0, (type & 2u) != 0, (type & 4u) != 0};
+      for (std::size_t plane = 0; plane < PlaneCount; plane++) {
+        if (values[plane]) {
+          planes[plane][bit / 8] = static_cast<char>(planes[plane][bit / 8] | 1u << (bit % 8));
+        }
+      }
+    }
+  }
+  for (const auto &plane : planes) {
+    bytes += plane;
+  }
+}
+
+Board readBoard(std::string_view bytes, std::size_t offset) {
+  const auto rows = readInteger<U16>(bytes, offset, FormatName);
+  const auto columns = readInteger<U16>(bytes, offset + sizeof(U16), FormatName);
+  const auto planeSize = getPlaneSize(rows, columns);
+  const auto planesOffset = offset + 2 * sizeof(U16);
+  if (planesOffset > bytes.size() || bytes.size() - planesOffset < PlaneCount * planeSize) {
+    throw std::invalid_argument("Corpus is truncated.");
+  }
+  const auto readBit = [bytes, planesOffset, planeSize](std::size_t plane, std::size_t bit) {
+    return (static_cast<U8>(bytes[planesOffset + plane * planeSize + bit / 8]) >> (bit % 8) & 1u) != 0;
+  };
+  std::vector<std::vector<std::optional<Tile>>> matrix(rows, std::vector<std::optional<Tile>>(columns));
+  for (std::size_t i = 0; i < rows; i++) {
+    for (std::size_t j = 0; j < columns; j++) {
+      const auto bit = i * columns + j;
+      if (readBit(0, bit)) {
+        const auto type = U32{readBit(2, bit)} | U32{readBit(3, bit)} << 1u | U32{readBit(4, bit)} << 2u;
+        matrix[i][j] = Tile(readBit(1, bit), tileTypeFromInteger(type));
+      }
+    }
+  }
+  return Board(matrix);
+}
+
+void writeSolution(std::string &bytes, const Solution &solution) {
+  writeInteger<U8>(bytes, solution.isOptimal() ? 1 : 0);
+  writeInteger<U32>(bytes, solution.getClicks().size());
+  for (const auto click : solution.getClicks()) {
+    writeInteger<U16>(bytes, static_cast<U16>(click.i));
+    writeInteger<U16>(bytes, static_cast<U16>(click.j));
+  }
+}
+
+Solution readSolution(std::string_view bytes, std::size_t offset) {
+  const auto optimal = readInteger<U8>(bytes, offset, FormatName) != 0;
+  const auto clickCount = readInteger<U32>(bytes, offset + sizeof(U8), FormatName);
+  std::vector<Position> clicks;
+  auto clickOffset = offset + sizeof(U8) + sizeof(U32);
+  for (U32 k = 0; k < clickCount; k++) {
+    const auto i = static_cast<S16>(readInteger<U16>(bytes, clickOffset, FormatName));
+    const auto j = static_cast<S16>(readInteger<U16>(bytes, clickOffset + sizeof(U16), FormatName));
+    clicks.emplace_back(static_cast<IndexType>(i), static_cast<IndexType>(j));
+    clickOffset += 2 * sizeof(U16);
+  }
+  return Solution(clicks, optimal);
+}
+} // namespace
+
+bool Corpus::isCorpus(std::string_view bytes) {
+  return bytes.starts_with(Magic);
+}
+
+Corpus::Corpus(std::string_view corpusBytes) : bytes(corpusBytes) {
+  if (!isCorpus(bytes)) {
+    throw std::invalid_argument("Not a corpus.");
+  }
+  const auto version = readInteger<U32>(bytes, Magic.size(), FormatName);
+  if (version != Version) {
+    throw std::invalid_argument("Unsupported corpus version: " + std::to_string(version) + ".");
+  }
+  entryCount = readInteger<U32>(bytes, Magic.size() + sizeof(U32), FormatName);
+  if ((bytes.size() - HeaderSize) / IndexRecordSize < entryCount) {
+    throw std::invalid_argument("Corpus is truncated.");
+  }
+}
+
+std::string_view Corpus::getIndexRecord(U32 index) const {
+  if (index >= entryCount) {
+    throw std::out_of_range("Corpus entry index is out of range.");
+  }
+  return bytes.substr(HeaderSize + index * IndexRecordSize, IndexRecordSize);
+}
+
+U32 Corpus::getEntryCount() const {
+  return entryCount;
+}
+
+Digest Corpus::getDigest(U32 index) const {
+  const auto record = getIndexRecord(index);
+  Digest digest{};
+  std::memcpy(digest.data(), record.data(), digest.size());
+  return digest;
+}
+
+CorpusEntry Corpus::getEntry(U32 index) const {
+  const auto record = getIndexRecord(index);
+  const auto boardOffset = readInteger<U64>(record, Digest().size(), FormatName);
+  const auto solutionOffset = readInteger<U64>(record, Digest().size() + sizeof(U64), FormatName);
+  std::optional<Solution> solution;
+  if (solutionOffset != 0) {
+    solution = readSolution(bytes, solutionOffset);
+  }
+  return CorpusEntry{getDigest(index), readBoard(bytes, boardOffset), solution};
+}
+
+std::optional<CorpusEntry> Corpus::find(const Digest &digest) const {
+  U32 low = 0;
+  U32 high = entryCount;
+  while (low < high) {
+    const auto middle = low + (high - low) / 2;
+    const auto middleDigest = getDigest(middle);
+    if (middleDigest < digest) {
+      low = middle + 1;
+    } else if (digest < middleDigest) {
+      high = middle;
+    } else {
+      return getEntry(middle);
+    }
+  }
+  return std::nullopt;
+}
+
+std::string Corpus::serialize(std::vector<CorpusEntry> entries) {
+  const auto compareDigests = [](const CorpusEntry &a, const CorpusEntry &b) { return a.digest < b.digest; };
+  std::stable_sort(std::begin(entries), std::end(entries), compareDigests);
+  const auto equalDigests = [](const CorpusEntry &a, const CorpusEntry &b) { return a.digest == b.digest; };
+  entries.erase(std::unique(std::begin(entries), std::end(entries), equalDigests), std::end(entries));
+  std::string data;
+  std::string index;
+  const auto dataOffset = HeaderSize + entries.size() * IndexRecordSize;
+  for (const auto &entry : entries) {
+    index.append(reinterpret_cast<const char *>(entry.digest.data()), entry.digest.size());
+    writeInteger<U64>(index, dataOffset + data.size());
+    writeBoard(data, entry.board);
+    if (entry.solution) {
+      writeInteger<U64>(index, dataOffset + data.size());
+      writeSolution(data, *entry.solution);
+    } else {
+      writeInteger<U64>(index, 0);
+    }
+  }
+  std::string bytes(Magic);
+  writeInteger<U32>(bytes, Version);
+  writeInteger<U32>(bytes, entries.size());
+  return bytes + index + data;
+}
+} // namespace WayoutPlayer
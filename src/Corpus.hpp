@@ -0,0 +1,58 @@
+#pragma once
+
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Board.hpp"
+#include "Hashing.hpp"
+#include "Solution.hpp"
+
+namespace WayoutPlayer {
+class CorpusEntry {
+public:
+  // The SHA-512 of the text file the board came from.
+  Digest digest;
+  Board board;
+  std::optional<Solution> solution;
+};
+
+/**
+ * A read-only view of a binary container of many boards and, optionally, their solutions.
+ *
+ * The container starts with a header and an index of fixed-size records sorted by digest, so it can be used directly
+ * from a memory-mapped file and searched by digest without reading the boards. Each board is stored as its dimensions
+ * followed by bit planes for tile presence, raised tiles and the three bits of the tile type.
+ */
+class Corpus {
+  std::string_view bytes;
+  U32 entryCount = 0;
+
+  [[nodiscard]] std::string_view getIndexRecord(U32 index) const;
+
+public:
+  /**
+   * Returns whether or not the bytes start like a corpus.
+   */
+  static bool isCorpus(std::string_view bytes);
+
+  /**
+   * Views the bytes as a corpus. The bytes must outlive the corpus.
+   */
+  explicit Corpus(std::string_view corpusBytes);
+
+  [[nodiscard]] U32 getEntryCount() const;
+
+  [[nodiscard]] Digest getDigest(U32 index) const;
+
+  [[nodiscard]] CorpusEntry getEntry(U32 index) const;
+
+  [[nodiscard]] std::optional<CorpusEntry> find(const Digest &digest) const;
+
+  /**
+   * Serializes the entries as a corpus. Entries with repeated digests are stored once.
+   */
+  static std::string serialize(std::vector<CorpusEntry> entries);
+};
+} // namespace WayoutPlayer
@@ -0,0 +1,167 @@
+#include "CorpusIndex.hpp"
+
+#include <algorithm>
+#include <filesystem>
+#include <map>
+#include <stdexcept>
+#include <tuple>
+
+#include "ThreadPool.hpp"
+
+namespace WayoutPlayer {
+namespace {
+constexpr std::string_view Header = "# wayout-player corpus index 1";
+const std::string TextExtension = ".txt";
+// Hashing tasks cover several files so that small files do not spend most of their time in the pool.
+constexpr std::size_t FilesPerTask = 64;
+
+std::string_view nextField(std::string_view &line) {
+  const auto end = line.find(' ');
+  if (end == std::string_view::npos) {
+    throw std::invalid_argument("Corpus index lines should have four fields.");
+  }
+  const auto field = line.substr(0, end);
+  line.remove_prefix(end + 1);
+  return field;
+}
+} // namespace
+
+void CorpusIndex::sortFiles() {
+  std::sort(std::begin(files), std::end(files), [](const IndexedFile &a, const IndexedFile &b) {
+    return a.filename < b.filename;
+  });
+  digestOrder.resize(files.size());
+  for (U32 i = 0; i < files.size(); i++) {
+    digestOrder[i] = i;
+  }
+  std::sort(std::begin(digestOrder), std::end(digestOrder), [this](U32 a, U32 b) {
+    return std::tie(files[a].digest, files[a].filename) < std::tie(files[b].digest, files[b].filename);
+  });
+}
+
+CorpusIndex CorpusIndex::fromString(std::string_view string) {
+  if (!string.starts_with(Header)) {
+    throw std::invalid_argument("Not a corpus index.");
+  }
+  CorpusIndex index;
+  string.remove_prefix(Header.size());
+  while (!string.empty()) {
+    const auto lineEnd = string.find('\n');
+    auto line = string.substr(0, lineEnd);
+    string.remove_prefix(lineEnd == std::string_view::npos ? string.size() : lineEnd + 1);
+    if (line.empty()) {
+      continue;
+    }
+    IndexedFile file;
+    file.digest = digestFromHexadecimal(nextField(line));
+    file.size = std::stoull(std::string(nextField(line)));
+    file.modificationTime = std::stoll(std::string(nextField(line)));
+    file.filename = line;
+    index.files.push_back(file);
+  }
+  index.sortFiles();
+  return index;
+}
+
+std::string CorpusIndex::toString() const {
+  std::string string(Header);
+  string += '\n';
+  for (const auto &file : files) {
+    string += digestToHexadecimal(file.digest);
+    string += ' ' + std::to_string(file.size) + ' ' + std::to_string(file.modificationTime) + ' ';
+    string += file.filename;
+    string += '\n';
+  }
+  return string;
+}
+
+const std::vector<IndexedFile> &CorpusIndex::getFiles() const {
+  return files;
+}
+
+U64 CorpusIndex::update(const std::string &directory, U32 threadCount) {
+  std::map<std::string, const IndexedFile *> previousFiles;
+  for (const auto &file : files) {
+    previousFiles[file.filename] = &file;
+  }
+  std::vector<IndexedFile> updatedFiles;
+  std::vector<std::size_t> changedFiles;
+  for (const auto &directoryEntry : std::filesystem::directory_iterator(directory)) {
+    if (!directoryEntry.is_regular_file() || directoryEntry.path().extension() != TextExtension) {
+      continue;
+    }
+    IndexedFile file;
+    file.filename = directoryEntry.path().filename().string();
+    file.size = directoryEntry.file_size();
+    file.modificationTime = directoryEntry.last_write_time().time_since_epoch().count();
+    const auto previous = previousFiles.find(file.filename);
+    if (previous != std::end(previousFiles) && previous->second->size == file.size &&
+        previous->second->modificationTime == file.modificationTime) {
+      file.digest = previous->second->digest;
+    } else {
+      changedFiles.push_back(updatedFiles.size());
+    }
+    updatedFiles.push_back(file);
+  }
+  ThreadPool threadPool(threadCount);
+  for (std::size_t begin = 0; begin < changedFiles.size(); begin += FilesPerTask) {
+    const auto end = std::min(begin + FilesPerTask, changedFiles.size());
+    threadPool.submit([&directory, &updatedFiles, &changedFiles, begin, end] {
+      for (auto i = begin; i < end; i++) {
+        auto &file = updatedFiles[changedFiles[i]];
+        file.digest = computeFileDigest((std::filesystem::path(directory) / file.filename).string());
+      }
+    });
+  }
+  threadPool.wait();
+  files = std::move(updatedFiles);
+  sortFiles();
+  return changedFiles.size();
+}
+
+std::vector<std::string> CorpusIndex::find(const Digest &digest) const {
+  const auto compare = [this](U32 a, const Digest &b) { return files[a].digest < b; };
+  auto iterator = std::lower_bound(std::begin(digestOrder), std::end(digestOrder), digest, compare);
+  std::vector<std::string> filenames;
+  for (; iterator != std::end(digestOrder) && files[*iterator].digest == digest; iterator++) {
+    filenames.push_back(files[*iterator].filename);
+  }
+  return filenames;
+}
+
+std::vector<std::vector<std::string>> CorpusIndex::findDuplicates() const {
+  std::vector<std::vector<std::string>> duplicates;
+  for (std::size_t begin = 0; begin < digestOrder.size();) {
+    auto end = begin + 1;
+    while (end < digestOrder.size() && files[digestOrder[end]].digest == files[digestOrder[begin]].digest) {
+      end++;
+    }
+    if (end - begin > 1) {
+      duplicates.emplace_back();
+      for (auto i = begin; i < end; i++) {
+        duplicates.back().push_back(files[digestOrder[i]].filename);
+      }
+    }
+    begin = end;
+  }
+  return duplicates;
+}
+
+void CorpusIndex::removeFiles(const std::set<std::string> &filenames) {
+  const auto newEnd = std::remove_if(std::begin(files), std::end(files), [&filenames](const IndexedFile &file) {
+    return filenames.contains(file.filename);
+  });
+  files.erase(newEnd, std::end(files));
+  sortFiles();
+}
+
+void CorpusIndex::renameFiles(const std::map<std::string, std::string> &newFilenames) {
+  for (auto &file : files) {
+    const auto iterator = newFilenames.find(file.filename);
+    if (iterator != std::end(newFilenames)) {
+      file.filename = iterator->second;
+    }
+  }
+  sortFiles();
+}
+} // namespace WayoutPlayer
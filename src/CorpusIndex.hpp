@@ -0,0 +1,70 @@
+#pragma once
+
+#include <map>
+#include <set>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Hashing.hpp"
+#include "Types.hpp"
+
+namespace WayoutPlayer {
+class IndexedFile {
+public:
+  std::string filename;
+  U64 size = 0;
+  S64 modificationTime = 0;
+  Digest digest{};
+};
+
+/**
+ * Maps the SHA-512 digests of the text files of a directory to their filenames.
+ *
+ * The index is kept on disk. A file whose size and modification time match its indexed entry is assumed to be unchanged
+ * and is not hashed again.
+ */
+class CorpusIndex {
+  // Sorted by filename.
+  std::vector<IndexedFile> files;
+  // Indices into files sorted by digest.
+  std::vector<U32> digestOrder;
+
+  void sortFiles();
+
+public:
+  CorpusIndex() = default;
+
+  static CorpusIndex fromString(std::string_view string);
+
+  [[nodiscard]] std::string toString() const;
+
+  [[nodiscard]] const std::vector<IndexedFile> &getFiles() const;
+
+  /**
+   * Brings the index up to date with the text files of the directory.
+   *
+   * New and changed files are hashed in parallel by the given number of threads.
+   *
+   * Returns how many files were hashed.
+   */
+  U64 update(const std::string &directory, U32 threadCount);
+
+  /**
+   * Returns the filenames of the files with the digest.
+   */
+  [[nodiscard]] std::vector<std::string> find(const Digest &digest) const;
+
+  /**
+   * Returns the filenames of the files which share their digest with another file, grouped by digest.
+   */
+  [[nodiscard]] std::vector<std::vector<std::string>> findDuplicates() const;
+
+  void removeFiles(const std::set<std::string> &filenames);
+
+  /**
+   * Renames the files of the index without hashing them again.
+   */
+  void renameFiles(const std::map<std::string, std::string> &newFilenames);
+};
+} // namespace WayoutPlayer
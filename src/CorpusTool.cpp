@@ -0,0 +1,191 @@
+#include "ArgumentParser.hpp"
+#include "Corpus.hpp"
+#include "CorpusIndex.hpp"
+#include "Filesystem.hpp"
+#include "Text.hpp"
+
+#include <filesystem>
+#include <iostream>
+#include <map>
+#include <set>
+#include <thread>
+
+using namespace WayoutPlayer;
+
+namespace {
+const std::string TextExtension = ".txt";
+
+void printUsage() {
+  std::cout << "Usage:" << '\n';
+  std::cout << "  corpus pack <input directory> <output directory> <corpus>" << '\n';
+  std::cout << "  corpus unpack <corpus> <input directory> <output directory>" << '\n';
+  std::cout << "  corpus index <input directory> <index>" << '\n';
+  std::cout << "  corpus find <index> <digest>" << '\n';
+  std::cout << "  corpus reorganize <input directory> <index>" << '\n';
+}
+
+/**
+ * Packs the boards of the input directory and the solutions of the output directory into a corpus.
+ */
+void pack(const std::string &inputDirectory, const std::string &outputDirectory, const std::string &corpusPath) {
+  std::vector<CorpusEntry> entries;
+  U64 solutionCount = 0;
+  for (const auto &directoryEntry : std::filesystem::directory_iterator(inputDirectory)) {
+    if (!directoryEntry.is_regular_file() || directoryEntry.path().extension() != TextExtension) {
+      continue;
+    }
+    const MappedFile boardFile(directoryEntry.path().string());
+    const auto contents = boardFile.getContents();
+    CorpusEntry entry{computeDigest(contents), Board::fromString(contents), std::nullopt};
+    const auto solutionPath = std::filesystem::path(outputDirectory) / directoryEntry.path().filename();
+    if (std::filesystem::is_regular_file(solutionPath)) {
+      try {
+        entry.solution = Solution::fromString(readFile(solutionPath.string()));
+        solutionCount++;
+      } catch (const std::invalid_argument &exception) {
+        std::cout << "Ignoring " << solutionPath.string() << ": " << exception.what() << '\n';
+      }
+    }
+    entries.push_back(entry);
+  }
+  const auto boardCount = entries.size();
+  writeFile(corpusPath, Corpus::serialize(std::move(entries)));
+  std::cout << "Packed " << toPluralizedString(boardCount, "board") << " and ";
+  std::cout << toPluralizedString(solutionCount, "solution") << "." << '\n';
+}
+
+/**
+ * Writes the boards of a corpus to the input directory and their solutions to the output directory.
+ *
+ * A corpus only holds the solutions, not the rest of the player output, so existing files are never overwritten.
+ */
+void unpack(const std::string &corpusPath, const std::string &inputDirectory, const std::string &outputDirectory) {
+  const MappedFile corpusFile(corpusPath);
+  const Corpus corpus(corpusFile.getContents());
+  std::vector<std::pair<std::filesystem::path, std::string>> files;
+  for (U32 index = 0; index < corpus.getEntryCount(); index++) {
+    const auto entry = corpus.getEntry(index);
+    const auto filename = digestToHexadecimal(entry.digest) + TextExtension;
+    files.emplace_back(std::filesystem::path(inputDirectory) / filename, entry.board.toString() + '\n');
+    if (entry.solution) {
+      files.emplace_back(std::filesystem::path(outputDirectory) / filename, entry.solution->toString() + '\n');
+    }
+  }
+  for (const auto &[path, contents] : files) {
+    if (std::filesystem::exists(path)) {
+      throw std::runtime_error("Cannot unpack to " + path.string() + ", which exists.");
+    }
+  }
+  std::filesystem::create_directories(inputDirectory);
+  std::filesystem::create_directories(outputDirectory);
+  for (const auto &[path, contents] : files) {
+    writeFile(path.string(), contents);
+  }
+  std::cout << "Unpacked " << toPluralizedString(corpus.getEntryCount(), "board") << "." << '\n';
+}
+
+/**
+ * Loads the index if it exists and brings it up to date with the input directory.
+ */
+CorpusIndex updateIndex(const std::string &inputDirectory, const std::string &indexPath) {
+  CorpusIndex index;
+  if (std::filesystem::exists(indexPath)) {
+    const MappedFile indexFile(indexPath);
+    index = CorpusIndex::fromString(indexFile.getContents());
+  }
+  const auto hashedFileCount = index.update(inputDirectory, std::thread::hardware_concurrency());
+  std::cout << "Indexed " << toPluralizedString(index.getFiles().size(), "file") << ", hashing ";
+  std::cout << toPluralizedString(hashedFileCount, "file") << "." << '\n';
+  return index;
+}
+
+void index(const std::string &inputDirectory, const std::string &indexPath) {
+  const auto index = updateIndex(inputDirectory, indexPath);
+  writeFile(indexPath, index.toString());
+  for (const auto &duplicates : index.findDuplicates()) {
+    std::cout << "Found redundant inputs:";
+    for (const auto &filename : duplicates) {
+      std::cout << ' ' << filename;
+    }
+    std::cout << '\n';
+  }
+}
+
+void find(const std::string &indexPath, const std::string &digest) {
+  const MappedFile indexFile(indexPath);
+  const auto index = CorpusIndex::fromString(indexFile.getContents());
+  for (const auto &filename : index.find(digestFromHexadecimal(digest))) {
+    std::cout << filename << '\n';
+  }
+}
+
+/**
+ * Removes redundant inputs and names every input after the SHA-512 of its contents.
+ */
+void reorganize(const std::string &inputDirectory, const std::string &indexPath) {
+  auto index = updateIndex(inputDirectory, indexPath);
+  const auto canonicalFilename = [](const IndexedFile &file) {
+    return digestToHexadecimal(file.digest) + TextExtension;
+  };
+  // Inputs which are already named after their digest are kept over their duplicates.
+  std::map<Digest, std::string> keptFilenames;
+  for (const auto &file : index.getFiles()) {
+    if (file.filename == canonicalFilename(file)) {
+      keptFilenames[file.digest] = file.filename;
+    }
+  }
+  for (const auto &file : index.getFiles()) {
+    keptFilenames.try_emplace(file.digest, file.filename);
+  }
+  const std::filesystem::path directory(inputDirectory);
+  std::set<std::string> removedFilenames;
+  std::map<std::string, std::string> newFilenames;
+  for (const auto &file : index.getFiles()) {
+    const auto source = directory / file.filename;
+    if (keptFilenames[file.digest] != file.filename) {
+      std::cout << "Removing " << file.filename << ", which collides with " << keptFilenames[file.digest] << "." << '\n';
+      std::filesystem::remove(source);
+      removedFilenames.insert(file.filename);
+    } else if (file.filename != canonicalFilename(file)) {
+      const auto destination = directory / canonicalFilename(file);
+      if (std::filesystem::exists(destination)) {
+        throw std::runtime_error("Cannot move " + source.string() + " to " + destination.string() + ", which exists.");
+      }
+      std::cout << "Moving " << file.filename << " to " << canonicalFilename(file) << "." << '\n';
+      std::filesystem::rename(source, destination);
+      newFilenames[file.filename] = canonicalFilename(file);
+    }
+  }
+  index.removeFiles(removedFilenames);
+  index.renameFiles(newFilenames);
+  writeFile(indexPath, index.toString());
+}
+} // namespace
+
+int main(int argc, char **argv) {
+  try {
+    ArgumentParser argumentParser;
+    argumentParser.parseArguments(argc, argv);
+    const auto command = argumentParser.getArgument(1);
+    if (command == "pack") {
+      pack(argumentParser.getArgument(2), argumentParser.getArgument(3), argumentParser.getArgument(4));
+    } else if (command == "unpack") {
+      unpack(argumentParser.getArgument(2), argumentParser.getArgument(3), argumentParser.getArgument(4));
+    } else if (command == "index") {
+      index(argumentParser.getArgument(2), argumentParser.getArgument(3));
+    } else if (command == "find") {
+      find(argumentParser.getArgument(2), argumentParser.getArgument(3));
+    } else if (command == "reorganize") {
+      reorganize(argumentParser.getArgument(2), argumentParser.getArgument(3));
+    } else {
+      printUsage();
+      return 1;
+    }
+  } catch (const std::exception &exception) {
+    std::cout << "Threw an exception." << '\n';
+    std::cout << "  " << exception.what() << '\n';
+    printUsage();
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,214 @@
+#include "EndgameTable.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <filesystem>
+#include <limits>
+#include <stdexcept>
+
+#include "Bits.hpp"
+#include "Hashing.hpp"
+#include "PackedBoard.hpp"
+
+namespace WayoutPlayer {
+namespace {
+constexpr std::string_view Magic = "WOPENDGT";
+constexpr std::string_view FormatName = "Endgame table";
+constexpr U32 Version = 1;
+const std::string Extension = ".egt";
+constexpr std::size_t HeaderSize = Magic.size() + 2 * sizeof(U32) + sizeof(U64);
+constexpr U32 NoState = std::numeric_limits<U32>::max();
+
+U64 getBlockedTypeMask(const BoardLayout &layout) {
+  U64 mask = 0;
+  for (S32 index = 0; index < layout.getTileCount(); index++) {
+    if (layout.getType(index) == TileType::Blocked) {
+      mask |= bitOf(index);
+    }
+  }
+  return mask;
+}
+} // namespace
+
+void EndgameTable::setContents(std::string_view contents) {
+  if (!contents.starts_with(Magic)) {
+    throw std::invalid_argument("Not an endgame table.");
+  }
+  if (readInteger<U32>(contents, Magic.size(), FormatName) != Version) {
+    throw std::invalid_argument("Unsupported endgame table version.");
+  }
+  tileCount = static_cast<S32>(readInteger<U32>(contents, Magic.size() + sizeof(U32), FormatName));
+  blockedTypeMask = readInteger<U64>(contents, Magic.size() + 2 * sizeof(U32), FormatName);
+  const auto stateBitCount = tileCount + std::popcount(blockedTypeMask);
+  if (stateBitCount > MaximumStateBitCount || (blockedTypeMask >> static_cast<U32>(tileCount)) != 0) {
+    throw std::invalid_argument("Endgame table has too many tiles.");
+  }
+  const auto stateCount = std::size_t{1} << static_cast<U32>(stateBitCount);
+  if (contents.size() != HeaderSize + 2 * stateCount) {
+    throw std::invalid_argument("Endgame table has the wrong size.");
+  }
+  distances = contents.substr(HeaderSize, stateCount);
+  bestClicks = contents.substr(HeaderSize + stateCount, stateCount);
+}
+
+U32 EndgameTable::toState(U64 up, U64 blocked) const {
+  return static_cast<U32>(up | extractBits(blocked, blockedTypeMask) << static_cast<U32>(tileCount));
+}
+
+bool EndgameTable::canBeBuilt(const BoardLayout &layout) {
+  return layout.getTileCount() + std::popcount(getBlockedTypeMask(layout)) <= MaximumStateBitCount;
+}
+
+std::string EndgameTable::getFilename(const BoardLayout &layout) {
+  auto minimumI = std::numeric_limits<S32>::max();
+  auto minimumJ = std::numeric_limits<S32>::max();
+  for (S32 index = 0; index < layout.getTileCount(); index++) {
+    minimumI = std::min(minimumI, static_cast<S32>(layout.getPosition(index).i));
+    minimumJ = std::min(minimumJ, static_cast<S32>(layout.getPosition(index).j));
+  }
+  std::string description = std::string(Magic) + std::to_string(Version);
+  for (S32 index = 0; index < layout.getTileCount(); index++) {
+    const auto position = layout.getPosition(index);
+    const auto relativePosition = Position(static_cast<IndexType>(position.i - minimumI),
+                                           static_cast<IndexType>(position.j - minimumJ));
+    description += " " + relativePosition.toString() + tileTypeToCharacter(layout.getType(index));
+  }
+  return digestToHexadecimal(computeDigest(description)) + Extension;
+}
+
+EndgameTable EndgameTable::build(const BoardLayout &layout) {
+  if (!canBeBuilt(layout)) {
+    const auto limitString = std::to_string(MaximumStateBitCount);
+    throw std::invalid_argument("Endgame tables support at most " + limitString +
+                                " tiles, counting blocked tiles twice.");
+  }
+  EndgameTable table;
+  table.tileCount = layout.getTileCount();
+  table.blockedTypeMask = getBlockedTypeMask(layout);
+  const auto tileCount = static_cast<U32>(table.tileCount);
+  const auto stateCount = U32{1} << (tileCount + static_cast<U32>(std::popcount(table.blockedTypeMask)));
+  const auto upMask = (U64{1} << tileCount) - 1;
+  // Every click from every board, as the index of the board it makes, to be followed backwards.
+  std::vector<U32> successors(std::size_t{stateCount} * tileCount, NoState);
+  std::vector<U32> predecessorOffsets(stateCount + 1, 0);
+  for (U32 state = 0; state < stateCount; state++) {
+    PackedBoard board;
+    board.up = state & upMask;
+    board.blocked = depositBits(state >> tileCount, table.blockedTypeMask);
+    for (U32 index = 0; index < tileCount; index++) {
+      if ((board.blocked & bitOf(static_cast<S32>(index))) != 0) {
+        continue;
+      }
+      auto derivedBoard = board;
+      derivedBoard.activate(layout, static_cast<S32>(index));
+      const auto derivedState = table.toState(derivedBoard.up, derivedBoard.blocked);
+      successors[state * tileCount + index] = derivedState;
+      predecessorOffsets[derivedState + 1]++;
+    }
+  }
+  for (U32 state = 0; state < stateCount; state++) {
+    predecessorOffsets[state + 1] += predecessorOffsets[state];
+  }
+  // The edges into every board, as the index of the edge, which gives both the board and the click it comes from.
+  std::vector<U32> predecessorEdges(predecessorOffsets.back());
+  auto nextPredecessor = predecessorOffsets;
+  for (U32 edge = 0; edge < successors.size(); edge++) {
+    if (successors[edge] != NoState) {
+      predecessorEdges[nextPredecessor[successors[edge]]++] = edge;
+    }
+  }
+  std::vector<char> bytes(std::begin(Magic), std::end(Magic));
+  writeInteger<U32>(bytes, Version);
+  writeInteger<U32>(bytes, tileCount);
+  writeInteger<U64>(bytes, table.blockedTypeMask);
+  bytes.resize(HeaderSize + 2 * std::size_t{stateCount}, static_cast<char>(Unsolvable));
+  const auto distanceTable = std::begin(bytes) + HeaderSize;
+  const auto bestClickTable = distanceTable + stateCount;
+  std::vector<U32> queue{0};
+  distanceTable[0] = 0;
+  for (std::size_t head = 0; head < queue.size(); head++) {
+    const auto state = queue[head];
+    const auto distance = static_cast<U8>(distanceTable[state]);
+    if (distance + 1 >= Unsolvable) {
+      throw std::runtime_error("Endgame table distances do not fit in a byte.");
+    }
+    for (auto k = predecessorOffsets[state]; k < predecessorOffsets[state + 1]; k++) {
+      const auto predecessor = predecessorEdges[k] / tileCount;
+      if (static_cast<U8>(distanceTable[predecessor]) == Unsolvable) {
+        distanceTable[predecessor] = static_cast<char>(distance + 1);
+        bestClickTable[predecessor] = static_cast<char>(predecessorEdges[k] % tileCount);
+        queue.push_back(predecessor);
+      }
+    }
+  }
+  table.bytes = std::move(bytes);
+  table.setContents(std::string_view(table.bytes.data(), table.bytes.size()));
+  return table;
+}
+
+EndgameTable EndgameTable::loadOrBuild(const BoardLayout &layout, const std::string &directory) {
+  const auto path = std::filesystem::path(directory) / getFilename(layout);
+  if (std::filesystem::is_regular_file(path)) {
+    EndgameTable table;
+    table.file = std::make_unique<MappedFile>(path.string());
+    table.setContents(table.file->getContents());
+    if (table.tileCount != layout.getTileCount() || table.blockedTypeMask != getBlockedTypeMask(layout)) {
+      throw std::invalid_argument("Endgame table does not match the layout.");
+    }
+    return table;
+  }
+  auto table = build(layout);
+  std::filesystem::create_directories(directory);
+  // Concurrent solvers may build the same table.
+  replaceFile(path.string(), table.serialize());
+  return table;
+}
+
+EndgameTable EndgameTable::deserialize(const BoardLayout &layout, std::string_view contents) {
+  EndgameTable table;
+  table.bytes.assign(std::begin(contents), std::end(contents));
+  table.setContents(std::string_view(table.bytes.data(), table.bytes.size()));
+  if (table.tileCount != layout.getTileCount() || table.blockedTypeMask != getBlockedTypeMask(layout)) {
+    throw std::invalid_argument("Endgame table does not match the layout.");
+  }
+  return table;
+}
+
+std::string_view EndgameTable::serialize() const {
+  return file ? file->getContents() : std::string_view(bytes.data(), bytes.size());
+}
+
+U8 EndgameTable::getDistance(const BoardLayout &layout, const Board &board) const {
+  const PackedBoard packedBoard(layout, board);
+  return static_cast<U8>(distances[toState(packedBoard.up, packedBoard.blocked)]);
+}
+
+Solution EndgameTable::findSolution(const BoardLayout &layout, const Board &board) const {
+  PackedBoard packedBoard(layout, board);
+  auto state = toState(packedBoard.up, packedBoard.blocked);
+  if (static_cast<U8>(distances[state]) == Unsolvable) {
+    throw std::runtime_error("Could not find a solution in the endgame table.");
+  }
+  std::vector<Position> clicks;
+  while (state != 0) {
+    const auto index = static_cast<S32>(static_cast<U8>(bestClicks[state]));
+    clicks.push_back(layout.getPosition(index));
+    packedBoard.activate(layout, index);
+    state = toState(packedBoard.up, packedBoard.blocked);
+  }
+  Solution solution(clicks, true);
+  solution.setExploredNodes(clicks.size() + 1);
+  return solution;
+}
+
+std::shared_ptr<const EndgameTable> EndgameTableCache::get(const BoardLayout &layout, const std::string &directory) {
+  const auto key = directory + "/" + EndgameTable::getFilename(layout);
+  std::scoped_lock lock(mutex);
+  auto &table = tables[key];
+  if (!table) {
+    auto builtTable = directory.empty() ? EndgameTable::build(layout) : EndgameTable::loadOrBuild(layout, directory);
+    table = std::make_shared<const EndgameTable>(std::move(builtTable));
+  }
+  return table;
+}
+} // namespace WayoutPlayer
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "Board.hpp"
+#include "BoardLayout.hpp"
+#include "Filesystem.hpp"
+#include "Solution.hpp"
+#include "Types.hpp"
+
+namespace WayoutPlayer {
+/**
+ * The distance to the solved board and a best click from every board with a layout, computed by a retrograde
+ * breadth-first search from the solved board.
+ *
+ * A board is one bit per tile for its up state followed by one bit per blocked tile of the layout for its blocked
+ * state, so the whole table fits in a few hundred kilobytes for small layouts. Tables only depend on the types of the
+ * tiles and their positions relative to each other, so they are stored on disk and read back by mapping them into
+ * memory.
+ */
+class EndgameTable {
+  std::unique_ptr<MappedFile> file;
+  std::vector<char> bytes;
+  S32 tileCount = 0;
+  U64 blockedTypeMask = 0;
+  std::string_view distances;
+  std::string_view bestClicks;
+
+  EndgameTable() = default;
+
+  void setContents(std::string_view contents);
+
+  [[nodiscard]] U32 toState(U64 up, U64 blocked) const;
+
+public:
+  static constexpr S32 MaximumStateBitCount = 16;
+  static constexpr U8 Unsolvable = 255;
+
+  /**
+   * Returns whether or not a table can be built for boards with the layout, which have few enough tiles.
+   */
+  static bool canBeBuilt(const BoardLayout &layout);
+
+  /**
+   * Returns the name under which the table for the layout is stored, which is the same wherever the tiles lie.
+   */
+  static std::string getFilename(const BoardLayout &layout);
+
+  static EndgameTable build(const BoardLayout &layout);
+
+  /**
+   * Maps the table for the layout from the directory, or builds it and writes it there.
+   */
+  static EndgameTable loadOrBuild(const BoardLayout &layout, const std::string &directory);
+
+  static EndgameTable deserialize(const BoardLayout &layout, std::string_view contents);
+
+  [[nodiscard]] std::string_view serialize() const;
+
+  /**
+   * Returns the number of clicks an optimal solution of the board has, or Unsolvable.
+   */
+  [[nodiscard]] U8 getDistance(const BoardLayout &layout, const Board &board) const;
+
+  /**
+   * Returns an optimal solution of the board, which must have the layout of the table.
+   */
+  [[nodiscard]] Solution findSolution(const BoardLayout &layout, const Board &board) const;
+};
+
+/**
+ * The endgame tables used by a solver, each one built or read at most once. Safe to use from many threads.
+ */
+class EndgameTableCache {
+  std::unordered_map<std::string, std::shared_ptr<const EndgameTable>> tables;
+  std::mutex mutex;
+
+public:
+  /**
+   * Returns the table for the layout, stored in the directory.
+   */
+  std::shared_ptr<const EndgameTable> get(const BoardLayout &layout, const std::string &directory);
+};
+} // namespace WayoutPlayer
@@ -1,8 +1,18 @@
 #include "Filesystem.hpp"
 
+#include <filesystem>
 #include <fstream>
+#include <functional>
 #include <sstream>
 #include <stdexcept>
+#include <thread>
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 
 namespace WayoutPlayer {
 std::string readFile(const std::string &path) {
@@ -15,4 +25,67 @@ std::string readFile(const std::string &path) {
   return buffer.str();
 }
 
+void writeFile(const std::string &path, std::string_view contents) {
+  std::ofstream output(path, std::ios::binary);
+  if (!output) {
+    throw std::runtime_error("Failed to open " + path + " for writing.");
+  }
+  output.write(contents.data(), static_cast<std::streamsize>(contents.size()));
+  if (!output) {
+    throw std::runtime_error("Failed to write " + path + ".");
+  }
+}
+
+void replaceFile(const std::string &path, std::string_view contents) {
+  auto temporaryPath = path;
+#ifdef __linux__
+  // Thread identifiers repeat across processes, so the process identifier tells apart those of other processes.
+  temporaryPath += "." + std::to_string(getpid());
+#endif
+  temporaryPath += "." + std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id()));
+  writeFile(temporaryPath, contents);
+  std::filesystem::rename(temporaryPath, path);
+}
+
+MappedFile::MappedFile(const std::string &path) {
+#ifdef __linux__
+  const auto descriptor = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (descriptor < 0) {
+    throw std::runtime_error("Failed to open " + path + ".");
+  }
+  struct stat status {};
+  if (fstat(descriptor, &status) != 0) {
+    close(descriptor);
+    throw std::runtime_error("Failed to get the size of " + path + ".");
+  }
+  size = static_cast<std::size_t>(status.st_size);
+  // Mapping an empty file fails, but there is nothing to map either.
+  if (size > 0) {
+    auto *address = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+    if (address == MAP_FAILED) {
+      close(descriptor);
+      throw std::runtime_error("Failed to map " + path + ".");
+    }
+    madvise(address, size, MADV_SEQUENTIAL);
+    data = static_cast<const char *>(address);
+  }
+  close(descriptor);
+#else
+  fallbackContents = readFile(path);
+  data = fallbackContents.data();
+  size = fallbackContents.size();
+#endif
+}
+
+MappedFile::~MappedFile() {
+#ifdef __linux__
+  if (data != nullptr) {
+    munmap(const_cast<char *>(data), size);
+  }
+#endif
+}
+
+std::string_view MappedFile::getContents() const {
+  return std::string_view(data, size);
+}
 } // namespace WayoutPlayer
@@ -1,7 +1,38 @@
 #pragma once
 
 #include <string>
+#include <string_view>
 
 namespace WayoutPlayer {
 std::string readFile(const std::string &path);
-}
+
+void writeFile(const std::string &path, std::string_view contents);
+
+/**
+ * Writes a file of its own and renames it into place, so that processes and threads writing the same path at once
+ * never let a reader see a partly written file.
+ */
+void replaceFile(const std::string &path, std::string_view contents);
+
+/**
+ * A read-only view of the contents of a file.
+ *
+ * On Linux the file is memory-mapped, so its contents are not copied. Elsewhere the file is read into memory.
+ */
+class MappedFile {
+  const char *data = nullptr;
+  std::size_t size = 0;
+  std::string fallbackContents;
+
+public:
+  explicit MappedFile(const std::string &path);
+
+  MappedFile(const MappedFile &) = delete;
+
+  MappedFile &operator=(const MappedFile &) = delete;
+
+  ~MappedFile();
+
+  [[nodiscard]] std::string_view getContents() const;
+};
+} // namespace WayoutPlayer
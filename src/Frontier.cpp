@@ -0,0 +1,209 @@
+#include "Frontier.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace WayoutPlayer {
+bool SearchState::hasClicked(S32 index) const {
+  return (clicked & (U64{1} << static_cast<U32>(index))) != 0;
+}
+
+Frontier::Frontier(std::pmr::memory_resource *memoryResource)
+    : resource(memoryResource), blocks(memoryResource), freeBlocks(memoryResource) {
+}
+
+Frontier::~Frontier() {
+  for (auto *block : blocks) {
+    resource->deallocate(block, BlockSize * sizeof(SearchState), alignof(SearchState));
+  }
+  for (auto *block : freeBlocks) {
+    resource->deallocate(block, BlockSize * sizeof(SearchState), alignof(SearchState));
+  }
+}
+
+bool Frontier::isEmpty() const {
+  return size == 0;
+}
+
+std::size_t Frontier::getSize() const {
+  return size;
+}
+
+const SearchState &Frontier::front() const {
+  if (isEmpty()) {
+    throw std::runtime_error("Cannot access the front of an empty frontier.");
+  }
+  return blocks.front()[head];
+}
+
+void Frontier::push(const SearchState &state) {
+  if (blocks.empty() || tail == BlockSize) {
+    SearchState *block;
+    if (freeBlocks.empty()) {
+      block = static_cast<SearchState *>(resource->allocate(BlockSize * sizeof(SearchState), alignof(SearchState)));
+    } else {
+      block = freeBlocks.back();
+      freeBlocks.pop_back();
+    }
+    blocks.push_back(block);
+    tail = 0;
+  }
+  blocks.back()[tail] = state;
+  tail++;
+  size++;
+}
+
+void Frontier::pop() {
+  if (isEmpty()) {
+    throw std::runtime_error("Cannot pop from an empty frontier.");
+  }
+  head++;
+  size--;
+  if (size == 0) {
+    while (!blocks.empty()) {
+      freeBlocks.push_back(blocks.back());
+      blocks.pop_back();
+    }
+    head = 0;
+    tail = 0;
+  } else if (head == BlockSize) {
+    freeBlocks.push_back(blocks.front());
+    blocks.pop_front();
+    head = 0;
+  }
+}
+
+void Frontier::prefetch(std::size_t distance) const {
+  if (distance >= size) {
+    return;
+  }
+  const auto offset = head + distance;
+  const auto *state = blocks[offset / BlockSize] + offset % BlockSize;
+#if defined(__GNUC__)
+  __builtin_prefetch(state);
+#else
+  static_cast<void>(state);
+#endif
+}
+
+LayeredFrontier::LayeredFrontier(std::pmr::memory_resource *memoryResource)
+    : resource(memoryResource), freeChunks(memoryResource), currentBlocks(memoryResource), nextBlocks(memoryResource),
+      pendingStates(memoryResource) {
+}
+
+LayeredFrontier::~LayeredFrontier() {
+  for (const auto *blocks : {&currentBlocks, &nextBlocks}) {
+    for (const auto &block : *blocks) {
+      for (auto *chunk : block.chunks) {
+        resource->deallocate(chunk, ChunkSize);
+      }
+    }
+  }
+  for (auto *chunk : freeChunks) {
+    resource->deallocate(chunk, ChunkSize);
+  }
+}
+
+bool LayeredFrontier::isEmpty() const {
+  return currentSize == 0 && nextSize == 0;
+}
+
+std::size_t LayeredFrontier::getSize() const {
+  return currentSize + nextSize;
+}
+
+void LayeredFrontier::push(const SearchState &state) {
+  pendingStates.push_back(state);
+  nextSize++;
+  if (pendingStates.size() == BlockSize) {
+    compressPendingStates();
+  }
+}
+
+void LayeredFrontier::compressPendingStates() {
+  if (pendingStates.empty()) {
+    return;
+  }
+  std::sort(std::begin(pendingStates), std::end(pendingStates), [](const SearchState &a, const SearchState &b) {
+    return a.board.blocked < b.board.blocked || (a.board.blocked == b.board.blocked && a.board.up < b.board.up);
+  });
+  Block block{std::pmr::vector<U8 *>(resource), 0, pendingStates.size()};
+  const auto writeByte = [this, &block](U8 byte) {
+    if (block.byteCount % ChunkSize == 0) {
+      if (freeChunks.empty()) {
+        block.chunks.push_back(static_cast<U8 *>(resource->allocate(ChunkSize)));
+      } else {
+        block.chunks.push_back(freeChunks.back());
+        freeChunks.pop_back();
+      }
+    }
+    block.chunks.back()[block.byteCount % ChunkSize] = byte;
+    block.byteCount++;
+  };
+  const auto write = [&writeByte](U64 value) {
+    while (value >= 0x80u) {
+      writeByte(static_cast<U8>(value | 0x80u));
+      value >>= 7u;
+    }
+    writeByte(static_cast<U8>(value));
+  };
+  PackedBoard previousBoard;
+  for (const auto &state : pendingStates) {
+    // Boards with the same blocked tiles are stored by how much their raised tiles grew, and others in full.
+    const auto blockedChange = state.board.blocked ^ previousBoard.blocked;
+    write(blockedChange);
+    write(blockedChange == 0 ? state.board.up - previousBoard.up : state.board.up);
+    write(state.clicked);
+    write(state.pathNode);
+    write(static_cast<U32>(state.firstClickableIndex));
+    previousBoard = state.board;
+  }
+  nextBlocks.push_back(std::move(block));
+  pendingStates.clear();
+}
+
+bool LayeredFrontier::popBlock(std::pmr::vector<SearchState> &states) {
+  if (currentBlocks.empty()) {
+    return false;
+  }
+  auto &block = currentBlocks.front();
+  std::size_t byteIndex = 0;
+  const auto read = [&block, &byteIndex]() {
+    U64 value = 0;
+    for (U32 shift = 0;; shift += 7) {
+      const auto byte = block.chunks[byteIndex / ChunkSize][byteIndex % ChunkSize];
+      byteIndex++;
+      value |= static_cast<U64>(byte & 0x7fu) << shift;
+      if ((byte & 0x80u) == 0) {
+        return value;
+      }
+    }
+  };
+  states.resize(block.stateCount);
+  PackedBoard previousBoard;
+  for (auto &state : states) {
+    const auto blockedChange = read();
+    const auto up = read();
+    state.board.blocked = previousBoard.blocked ^ blockedChange;
+    state.board.up = blockedChange == 0 ? previousBoard.up + up : up;
+    state.clicked = read();
+    state.pathNode = static_cast<U32>(read());
+    state.firstClickableIndex = static_cast<S32>(read());
+    previousBoard = state.board;
+  }
+  freeChunks.insert(std::end(freeChunks), std::begin(block.chunks), std::end(block.chunks));
+  currentSize -= block.stateCount;
+  currentBlocks.pop_front();
+  return true;
+}
+
+void LayeredFrontier::advanceLayer() {
+  if (currentSize != 0) {
+    throw std::runtime_error("Cannot advance to the next layer before the current one is empty.");
+  }
+  compressPendingStates();
+  std::swap(currentBlocks, nextBlocks);
+  currentSize = nextSize;
+  nextSize = 0;
+}
+} // namespace WayoutPlayer
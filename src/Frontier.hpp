@@ -0,0 +1,129 @@
+#pragma once
+
+#include <cstddef>
+#include <deque>
+#include <memory_resource>
+#include <vector>
+
+#include "PackedBoard.hpp"
+#include "Types.hpp"
+
+namespace WayoutPlayer {
+/**
+ * A board reached by the breadth-first search together with how it was reached.
+ */
+class SearchState {
+public:
+  PackedBoard board;
+  U64 clicked = 0;
+  U32 pathNode = 0;
+  // When clicks are generated in canonical order, only tiles at or after this row-major index may be clicked.
+  S32 firstClickableIndex = 0;
+
+  [[nodiscard]] bool hasClicked(S32 index) const;
+};
+
+/**
+ * A first-in first-out queue of search states stored contiguously in fixed-size blocks.
+ *
+ * Pushing never moves stored states, so the front state can be used in place while its successors are pushed. Blocks
+ * which have been consumed are reused for new states, so the queue only holds as many blocks as its largest size.
+ */
+class Frontier {
+  std::pmr::memory_resource *resource;
+  std::pmr::deque<SearchState *> blocks;
+  std::pmr::vector<SearchState *> freeBlocks;
+  // The offset of the front state in the first block and of the next free slot in the last block.
+  std::size_t head = 0;
+  std::size_t tail = 0;
+  std::size_t size = 0;
+
+public:
+  static constexpr std::size_t BlockSize = 2048;
+
+  explicit Frontier(std::pmr::memory_resource *memoryResource);
+
+  Frontier(const Frontier &) = delete;
+
+  Frontier &operator=(const Frontier &) = delete;
+
+  ~Frontier();
+
+  [[nodiscard]] bool isEmpty() const;
+
+  [[nodiscard]] std::size_t getSize() const;
+
+  [[nodiscard]] const SearchState &front() const;
+
+  void push(const SearchState &state);
+
+  void pop();
+
+  /**
+   * Hints the processor to load the state which will be at the front after the given number of pops.
+   */
+  void prefetch(std::size_t distance) const;
+};
+
+/**
+ * The frontier of a breadth-first search as two layers, the states being expanded and the states they generate, stored
+ * compressed.
+ *
+ * Generated states are buffered until a block is full, and the block is then sorted by board so that consecutive boards
+ * can be stored as the differences between them, in variable-length integers like every other field. The order in
+ * which the states of a layer are expanded does not matter, so blocks are expanded in the order they were made. Blocks
+ * are stored in chunks of a fixed size, which are reused once their block has been expanded.
+ */
+class LayeredFrontier {
+  class Block {
+  public:
+    std::pmr::vector<U8 *> chunks;
+    std::size_t byteCount = 0;
+    std::size_t stateCount = 0;
+  };
+
+  std::pmr::memory_resource *resource;
+  std::pmr::vector<U8 *> freeChunks;
+  std::pmr::deque<Block> currentBlocks;
+  std::pmr::deque<Block> nextBlocks;
+  std::pmr::vector<SearchState> pendingStates;
+  std::size_t currentSize = 0;
+  std::size_t nextSize = 0;
+
+  void compressPendingStates();
+
+public:
+  static constexpr std::size_t BlockSize = 1u << 16u;
+  static constexpr std::size_t ChunkSize = 1u << 14u;
+
+  explicit LayeredFrontier(std::pmr::memory_resource *memoryResource);
+
+  LayeredFrontier(const LayeredFrontier &) = delete;
+
+  LayeredFrontier &operator=(const LayeredFrontier &) = delete;
+
+  ~LayeredFrontier();
+
+  [[nodiscard]] bool isEmpty() const;
+
+  /**
+   * Returns the number of states in both layers.
+   */
+  [[nodiscard]] std::size_t getSize() const;
+
+  /**
+   * Adds a state to the next layer.
+   */
+  void push(const SearchState &state);
+
+  /**
+   * Removes a block of states from the current layer and writes them, or returns false if the current layer is empty.
+   */
+  bool popBlock(std::pmr::vector<SearchState> &states);
+
+  /**
+   * Makes the next layer the current one. The current layer must be empty.
+   */
+  void advanceLayer();
+};
+} // namespace WayoutPlayer
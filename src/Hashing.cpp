@@ -1,29 +1,117 @@
 #include "Hashing.hpp"
 
 #include <cassert>
+#include <fstream>
 #include <stdexcept>
 
 #include <openssl/evp.h>
 
 namespace WayoutPlayer {
+namespace {
+constexpr std::size_t FileChunkSize = 128u * 1024u;
+
+Sha512Hasher &getThreadHasher() {
+  thread_local Sha512Hasher hasher;
+  return hasher;
+}
+} // namespace
+
 U64 hashString(const std::string &string) {
-  const std::string DigestName = "SHA512";
-  auto *messageDigestContext = EVP_MD_CTX_new();
-  auto *messageDigest = EVP_get_digestbyname(DigestName.c_str());
-  if (messageDigest == nullptr) {
-    throw std::runtime_error("Unknown message digest " + DigestName + ".");
-  }
-  EVP_DigestInit_ex(messageDigestContext, messageDigest, nullptr);
-  EVP_DigestUpdate(messageDigestContext, string.c_str(), string.size());
-  unsigned char messageDigestValue[EVP_MAX_MD_SIZE];
-  unsigned int messageDigestLength = 0;
-  EVP_DigestFinal_ex(messageDigestContext, messageDigestValue, &messageDigestLength);
-  assert(messageDigestLength >= sizeof(U64));
-  EVP_MD_CTX_free(messageDigestContext);
+  const auto digest = computeDigest(string);
   U64 truncatedDigest = 0;
   for (unsigned int i = 0; i < sizeof(U64); i++) {
-    truncatedDigest = (truncatedDigest << 8u) | messageDigestValue[i];
+    truncatedDigest = (truncatedDigest << 8u) | digest[i];
   }
   return truncatedDigest;
 }
-} // namespace WayoutPlayer
\ No newline at end of file
+
+Sha512Hasher::Sha512Hasher() : context(EVP_MD_CTX_new()) {
+  if (context == nullptr) {
+    throw std::runtime_error("Failed to create a message digest context.");
+  }
+  if (EVP_DigestInit_ex(static_cast<EVP_MD_CTX *>(context), EVP_sha512(), nullptr) != 1) {
+    EVP_MD_CTX_free(static_cast<EVP_MD_CTX *>(context));
+    throw std::runtime_error("Failed to initialize SHA-512.");
+  }
+}
+
+Sha512Hasher::~Sha512Hasher() {
+  EVP_MD_CTX_free(static_cast<EVP_MD_CTX *>(context));
+}
+
+void Sha512Hasher::update(std::string_view data) {
+  EVP_DigestUpdate(static_cast<EVP_MD_CTX *>(context), data.data(), data.size());
+}
+
+Digest Sha512Hasher::finish() {
+  auto *messageDigestContext = static_cast<EVP_MD_CTX *>(context);
+  unsigned char messageDigestValue[EVP_MAX_MD_SIZE];
+  unsigned int messageDigestLength = 0;
+  EVP_DigestFinal_ex(messageDigestContext, messageDigestValue, &messageDigestLength);
+  assert(messageDigestLength == Digest().size());
+  EVP_DigestInit_ex(messageDigestContext, nullptr, nullptr);
+  Digest digest{};
+  for (std::size_t i = 0; i < digest.size(); i++) {
+    digest[i] = messageDigestValue[i];
+  }
+  return digest;
+}
+
+Digest computeDigest(std::string_view string) {
+  auto &hasher = getThreadHasher();
+  hasher.update(string);
+  return hasher.finish();
+}
+
+Digest computeFileDigest(const std::string &path) {
+  std::ifstream input(path, std::ios::binary);
+  if (!input) {
+    throw std::runtime_error("Failed to open " + path + ".");
+  }
+  auto &hasher = getThreadHasher();
+  std::string chunk(FileChunkSize, '\0');
+  while (input) {
+    input.read(chunk.data(), static_cast<std::streamsize>(chunk.size()));
+    hasher.update(std::string_view(chunk.data(), static_cast<std::size_t>(input.gcount())));
+  }
+  if (input.bad()) {
+    hasher.finish();
+    throw std::runtime_error("Failed to read " + path + ".");
+  }
+  return hasher.finish();
+}
+
+std::string digestToHexadecimal(const Digest &digest) {
+  const std::string Digits = "0123456789abcdef";
+  std::string hexadecimal;
+  hexadecimal.reserve(2 * digest.size());
+  for (const auto byte : digest) {
+    hexadecimal += Digits[byte >> 4u];
+    hexadecimal += Digits[byte & 15u];
+  }
+  return hexadecimal;
+}
+
+Digest digestFromHexadecimal(std::string_view hexadecimal) {
+  Digest digest{};
+  if (hexadecimal.size() != 2 * digest.size()) {
+    throw std::invalid_argument("A digest should have " + std::to_string(2 * digest.size()) + " hexadecimal digits.");
+  }
+  const auto digitValue = [](char digit) -> U32 {
+    if (digit >= '0' && digit <= '9') {
+      return digit - '0';
+    }
+    if (digit >= 'a' && digit <= 'f') {
+      return digit - 'a' + 10;
+    }
+    if (digit >= 'A' && digit <= 'F') {
+      return digit - 'A' + 10;
+    }
+    throw std::invalid_argument("Invalid hexadecimal digit: " + std::string(1, digit) + ".");
+  };
+  for (std::size_t i = 0; i < digest.size(); i++) {
+    digest[i] = static_cast<U8>(digitValue(hexadecimal[2 * i]) << 4u | digitValue(hexadecimal[2 * i + 1]));
+  }
+  return digest;
+}
+} // namespace WayoutPlayer
@@ -1,12 +1,55 @@
 #pragma once
 
 #include "Types.hpp"
+
+#include <array>
 #include <string>
+#include <string_view>
 
 namespace WayoutPlayer {
+using Digest = std::array<U8, 64>;
+
+/**
+ * Computes SHA-512 digests incrementally.
+ *
+ * The digest context is created once and reset after every digest, so a hasher can be reused for many inputs.
+ */
+class Sha512Hasher {
+  void *context;
+
+public:
+  Sha512Hasher();
+
+  Sha512Hasher(const Sha512Hasher &) = delete;
+
+  Sha512Hasher &operator=(const Sha512Hasher &) = delete;
+
+  ~Sha512Hasher();
+
+  void update(std::string_view data);
+
+  /**
+   * Returns the digest of everything passed to update() since the last digest.
+   */
+  Digest finish();
+};
 
 /**
  * Returns the first 64 bits of the SHA-512 hash of the string.
  */
 U64 hashString(const std::string &string);
+
+/**
+ * Returns the SHA-512 hash of the string.
+ */
+Digest computeDigest(std::string_view string);
+
+/**
+ * Returns the SHA-512 hash of the contents of a file, which is read in chunks.
+ */
+Digest computeFileDigest(const std::string &path);
+
+std::string digestToHexadecimal(const Digest &digest);
+
+Digest digestFromHexadecimal(std::string_view hexadecimal);
 } // namespace WayoutPlayer
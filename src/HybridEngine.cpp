@@ -0,0 +1,201 @@
+#include "HybridEngine.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <limits>
+#include <memory_resource>
+#include <optional>
+#include <stdexcept>
+#include <unordered_set>
+
+#include "Arena.hpp"
+#include "BoardLayout.hpp"
+#include "LinearSystem.hpp"
+#include "PackedBoard.hpp"
+#include "Text.hpp"
+
+namespace WayoutPlayer {
+namespace {
+// Every board finished algebraically visits all solutions of the linear system.
+constexpr std::size_t MaximumEnumeratedNullity = 16;
+
+/**
+ * Returns the tiles whose changes depend on when they happen, which are blocked tiles and twins out of step.
+ */
+U64 getNonlinearMask(const BoardLayout &layout, const PackedBoard &board) {
+  const auto twinMask = layout.getTwinMask();
+  const auto raisedTwins = board.up & twinMask;
+  const auto twinsInStep = raisedTwins == 0 || raisedTwins == twinMask;
+  return board.blocked | (twinsInStep ? 0 : twinMask);
+}
+
+/**
+ * Returns the indices of the tiles which are clicked by solving the linear system, which are all but the taps.
+ */
+std::vector<S32> findFreeIndices(const BoardLayout &layout) {
+  std::vector<S32> freeIndices;
+  for (S32 index = 0; index < layout.getTileCount(); index++) {
+    if (layout.getType(index) != TileType::Tap) {
+      freeIndices.push_back(index);
+    }
+  }
+  return freeIndices;
+}
+
+/**
+ * Returns the system whose columns are the effects of the clicks once no tile is blocked and all twins are in step.
+ */
+LinearSystem buildLinearSystem(const BoardLayout &layout, const std::vector<S32> &freeIndices) {
+  std::vector<U64> effects;
+  for (const auto index : freeIndices) {
+    PackedBoard board;
+    board.activate(layout, index);
+    effects.push_back(board.up);
+  }
+  return LinearSystem(effects);
+}
+} // namespace
+
+HybridEngine::HybridEngine(const SolverConfiguration &configuration) : solverConfiguration(configuration) {
+}
+
+bool HybridEngine::canSolve(const Board &board) const {
+  const BoardLayout layout(board);
+  if (!layout.canBePacked()) {
+    return false;
+  }
+  const auto system = buildLinearSystem(layout, findFreeIndices(layout));
+  return system.getNullSpaceBasis().size() <= MaximumEnumeratedNullity;
+}
+
+SolveTask HybridEngine::solve(Board board) const {
+  if (!canSolve(board)) {
+    const auto limitString = std::to_string(BoardLayout::MaximumPackedTileCount);
+    throw std::invalid_argument("Hybrid search supports components of at most " + limitString +
+                                " tiles with few sets of clicks without effect.");
+  }
+  if (board.isSolved()) {
+    co_return Solution({}, true);
+  }
+  const BoardLayout layout(board);
+  const auto tileCount = layout.getTileCount();
+  const auto freeIndices = findFreeIndices(layout);
+  const auto system = buildLinearSystem(layout, freeIndices);
+  const auto clickReaches = layout.computeClickReaches();
+  Arena arena(getSearchResource(solverConfiguration.getHugePages()));
+  CountingMemoryResource pathResource(arena.getResource());
+  CountingMemoryResource frontierResource(arena.getResource());
+  class SearchNode {
+  public:
+    PackedBoard board;
+    U32 parent = 0;
+    S32 index = -1;
+  };
+  const auto NoParent = std::numeric_limits<U32>::max();
+  std::pmr::vector<SearchNode> nodes(&pathResource);
+  struct Hash {
+    std::size_t operator()(const PackedBoard &packedBoard) const {
+      return packedBoard.hash();
+    }
+  };
+  std::pmr::unordered_set<PackedBoard, Hash> seenBoards(arena.getResource());
+  auto initialBoard = PackedBoard(layout, board);
+  nodes.push_back({initialBoard, NoParent, -1});
+  U32 initialNode = 0;
+  S32 depth = 0;
+  for (const auto index : layout.findRaisedTaps(initialBoard.up)) {
+    initialBoard.activate(layout, index);
+    nodes.push_back({initialBoard, initialNode, index});
+    initialNode = static_cast<U32>(nodes.size() - 1);
+    depth++;
+  }
+  seenBoards.insert(initialBoard);
+  std::pmr::vector<U32> layer({initialNode}, &frontierResource);
+  std::pmr::vector<U32> nextLayer(&frontierResource);
+  std::optional<U32> bestNode;
+  U64 bestClicks = 0;
+  auto bestClickCount = std::numeric_limits<S32>::max();
+  U64 exploredNodes = 0;
+  const auto maximumBoardHashTableSize = solverConfiguration.getMaximumBoardHashTableSize();
+  const auto progressInterval = solverConfiguration.getProgressInterval();
+  const auto start = std::chrono::steady_clock::now();
+  while (!layer.empty() && depth < bestClickCount) {
+    nextLayer.clear();
+    for (const auto nodeIndex : layer) {
+      exploredNodes++;
+      const auto nodeBoard = nodes[nodeIndex].board;
+      const auto nonlinearMask = getNonlinearMask(layout, nodeBoard);
+      if (nonlinearMask == 0) {
+        const auto clicks = system.solveWithFewestUnknowns(nodeBoard.up);
+        if (clicks && depth + std::popcount(*clicks) < bestClickCount) {
+          bestNode = nodeIndex;
+          bestClicks = *clicks;
+          bestClickCount = depth + std::popcount(*clicks);
+        }
+        continue;
+      }
+      if (depth + 1 >= bestClickCount) {
+        continue;
+      }
+      // Clicks which reach no blocked tile and no twin out of step can be made after all the others.
+      for (S32 index = 0; index < tileCount; index++) {
+        const auto type = nodeBoard.getType(layout, index);
+        if (type == TileType::Tap || type == TileType::Blocked || (clickReaches[index] & nonlinearMask) == 0) {
+          continue;
+        }
+        auto derivedBoard = nodeBoard;
+        derivedBoard.activate(layout, index);
+        if (seenBoards.insert(derivedBoard).second) {
+          nodes.push_back({derivedBoard, nodeIndex, index});
+          nextLayer.push_back(static_cast<U32>(nodes.size() - 1));
+        }
+      }
+      if (seenBoards.size() > maximumBoardHashTableSize) {
+        const auto limitString = std::to_string(maximumBoardHashTableSize);
+        throw std::runtime_error("Board hash table size exceeded the limit of " + limitString + ".");
+      }
+      if (exploredNodes % progressInterval == 0) {
+        SolveProgress progress;
+        progress.depth = depth;
+        progress.frontierSize = layer.size() + nextLayer.size();
+        progress.exploredNodes = exploredNodes;
+        const auto seconds = std::chrono::duration<F64>(std::chrono::steady_clock::now() - start).count();
+        progress.nodesPerSecond = seconds > 0.0 ? static_cast<F64>(exploredNodes) / seconds : 0.0;
+        co_yield progress;
+      }
+    }
+    std::swap(layer, nextLayer);
+    depth++;
+  }
+  if (!bestNode) {
+    const auto exploredNodeCount = toPluralizedString(exploredNodes, "node");
+    throw std::runtime_error("Could not find a solution after exploring " + exploredNodeCount + ".");
+  }
+  std::vector<Position> clicks;
+  for (auto node = *bestNode; node != NoParent; node = nodes[node].parent) {
+    if (nodes[node].index >= 0) {
+      clicks.push_back(layout.getPosition(nodes[node].index));
+    }
+  }
+  std::reverse(std::begin(clicks), std::end(clicks));
+  for (auto remaining = bestClicks; remaining != 0; remaining &= remaining - 1) {
+    clicks.push_back(layout.getPosition(freeIndices[std::countr_zero(remaining)]));
+  }
+  Solution solution(clicks, true);
+  solution.setExploredNodes(exploredNodes);
+  solution.setDistinctNodes(seenBoards.size());
+  auto &memoryBreakdown = solution.getMemoryBreakdown();
+  memoryBreakdown.frontierBytes = frontierResource.getPeakBytes();
+  memoryBreakdown.seenBoardBytes = estimateHashSetBytes(seenBoards);
+  memoryBreakdown.pathBytes = pathResource.getPeakBytes();
+  co_return solution;
+}
+
+Solution HybridEngine::findSolution(const Board &board) const {
+  auto task = solve(board);
+  while (task.resume()) {
+  }
+  return task.getSolution();
+}
+} // namespace WayoutPlayer
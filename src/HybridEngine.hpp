@@ -0,0 +1,35 @@
+#pragma once
+
+#include "Board.hpp"
+#include "Solution.hpp"
+#include "SolveTask.hpp"
+#include "SolverConfiguration.hpp"
+
+namespace WayoutPlayer {
+/**
+ * Finds minimum solutions for boards which are linear except for a few Blocked tiles and Twin tiles out of step.
+ *
+ * Once every tile is unblocked and all twins are in the same state, clicks commute and the rest of a solution is the
+ * lightest solution of a linear system over GF(2). Only the clicks which reach a blocked tile or a twin out of step
+ * before that act differently depending on when they are made, so just the sequences of such clicks are searched, in
+ * breadth-first order, and every board on which they leave no such tile is finished algebraically.
+ */
+class HybridEngine {
+  const SolverConfiguration &solverConfiguration;
+
+public:
+  explicit HybridEngine(const SolverConfiguration &configuration);
+
+  /**
+   * Returns whether or not this engine can solve the board.
+   */
+  [[nodiscard]] bool canSolve(const Board &board) const;
+
+  /**
+   * Returns a solve of the board which reports its progress every so many expanded nodes. The engine must outlive it.
+   */
+  [[nodiscard]] SolveTask solve(Board board) const;
+
+  [[nodiscard]] Solution findSolution(const Board &board) const;
+};
+} // namespace WayoutPlayer
@@ -0,0 +1,477 @@
+#include "IterativeDeepeningEngine.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <deque>
+#include <limits>
+#include <mutex>
+#include <optional>
+#include <thread>
+
+#include "Bits.hpp"
+#include "BoardLayout.hpp"
+#include "PackedBoard.hpp"
+#include "PatternDatabase.hpp"
+#include "Text.hpp"
+
+namespace WayoutPlayer {
+namespace {
+// Enough subtrees per thread that threads which finish early can steal work from the others.
+constexpr U64 TasksPerThread = 32;
+// Without Chain tiles, a click changes the state of at most five tiles which are not twins.
+constexpr S32 MaximumTilesChangedByAClick = 5;
+constexpr S32 NoBound = std::numeric_limits<S32>::max();
+constexpr U64 NoTask = std::numeric_limits<U64>::max();
+
+using ClickList = std::array<S32, BoardLayout::MaximumPackedTileCount>;
+
+class Node {
+public:
+  PackedBoard board;
+  U64 clicked = 0;
+  // Tiles which were clicked once and may be clicked once more, because their first click unblocked a tile.
+  U64 clickableAgain = 0;
+  // When clicks are generated in canonical order, only tiles at or after this row-major index may be clicked.
+  S32 firstClickableIndex = 0;
+};
+
+class Task {
+public:
+  Node node;
+  std::vector<S32> path;
+};
+
+class TranspositionEntry {
+public:
+  PackedBoard board;
+  U64 clicked = 0;
+  U64 clickableAgain = 0;
+  U32 iteration = 0;
+  S32 depth = 0;
+};
+
+/**
+ * What the search may do on a board, which does not change while the board is solved.
+ */
+class SearchRules {
+public:
+  const BoardLayout &layout;
+  bool orderingClicksCanonically = false;
+  bool limitingRepeatedClicks = false;
+  bool directional = false;
+  bool flippingOnlyUp = false;
+  bool estimatingClicks = false;
+  std::optional<PatternDatabase> patternDatabase;
+  // For every tile, the tiles which clicking it may invert or unblock.
+  std::vector<U64> clickReaches;
+  // Indexed by the first clickable index, the tiles which no click in canonical order can change anymore.
+  std::vector<U64> unreachableMasks;
+
+  explicit SearchRules(const BoardLayout &boardLayout) : layout(boardLayout) {
+  }
+
+  /**
+   * Returns a lower bound on the number of clicks needed to solve the node, or PatternDatabase::Unsolvable.
+   */
+  [[nodiscard]] S32 estimateClicks(const Node &node) const {
+    if (!estimatingClicks) {
+      return 0;
+    }
+    const auto changesNeeded = std::popcount(node.board.up & ~layout.getTwinMask()) + std::popcount(node.board.blocked);
+    const auto estimate = (changesNeeded + MaximumTilesChangedByAClick - 1) / MaximumTilesChangedByAClick;
+    if (!patternDatabase) {
+      return estimate;
+    }
+    const auto patternEstimate = patternDatabase->estimateClicks(node.board);
+    return patternEstimate == PatternDatabase::Unsolvable ? patternEstimate : std::max(estimate, patternEstimate);
+  }
+
+  [[nodiscard]] bool isUnsolvable(const Node &node) const {
+    return !unreachableMasks.empty() && (node.board.up & unreachableMasks[node.firstClickableIndex]) != 0;
+  }
+
+  /**
+   * Writes the indices of the tiles which may be clicked next, as the breadth-first search would click them.
+   *
+   * Returns how many indices were written.
+   */
+  S32 listClicks(const Node &node, ClickList &clicks) const {
+    S32 clickCount = 0;
+    const auto firstIndex = orderingClicksCanonically ? node.firstClickableIndex : 0;
+    for (S32 index = firstIndex; index < layout.getTileCount(); index++) {
+      if (limitingRepeatedClicks && (node.clicked & ~node.clickableAgain & bitOf(index)) != 0) {
+        continue;
+      }
+      const auto type = node.board.getType(layout, index);
+      const auto up = (node.board.up & bitOf(index)) != 0;
+      if (type == TileType::Tap || type == TileType::Blocked) {
+        continue;
+      }
+      if (flippingOnlyUp && !up) {
+        continue;
+      }
+      if (directional) {
+        // Some click on the first raised tile or on one of its neighbors must lower it.
+        if (up) {
+          clicks[clickCount++] = index;
+          for (const auto neighbor : layout.getNeighbors(index)) {
+            if (neighbor >= 0) {
+              clicks[clickCount++] = neighbor;
+            }
+          }
+          return clickCount;
+        }
+      } else {
+        clicks[clickCount++] = index;
+      }
+    }
+    return clickCount;
+  }
+};
+
+/**
+ * The state shared by all threads during one iteration.
+ */
+class Iteration {
+public:
+  S32 bound = 0;
+  U32 number = 0;
+  std::vector<Task> tasks;
+  std::atomic<S32> nextBound = NoBound;
+  std::atomic<U64> bestTask = NoTask;
+  std::mutex solutionMutex;
+  std::vector<S32> solutionPath;
+
+  void lowerNextBound(S32 estimate) {
+    auto current = nextBound.load(std::memory_order_relaxed);
+    while (estimate < current && !nextBound.compare_exchange_weak(current, estimate)) {
+    }
+  }
+
+  void offerSolution(U64 task, const std::vector<S32> &path) {
+    const std::lock_guard<std::mutex> lock(solutionMutex);
+    if (task < bestTask.load()) {
+      bestTask = task;
+      solutionPath = path;
+    }
+  }
+};
+
+/**
+ * A depth-first search of one subtree at a time, owned by a single thread.
+ */
+class Searcher {
+  const SearchRules &rules;
+  Iteration &iteration;
+  std::vector<TranspositionEntry> transpositionTable;
+  U64 task = 0;
+  bool aborted = false;
+  // When collecting tasks, nodes at this depth are collected instead of searched.
+  std::optional<S32> splitDepth;
+
+  [[nodiscard]] U64 getTranspositionKey(const Node &node) const {
+    return rules.limitingRepeatedClicks ? node.clicked : 0;
+  }
+
+  [[nodiscard]] TranspositionEntry *findTranspositionEntry(const Node &node) {
+    if (transpositionTable.empty()) {
+      return nullptr;
+    }
+    const auto hash = node.board.hash() ^ getTranspositionKey(node) * 0x9e3779b97f4a7c15u;
+    return &transpositionTable[hash & (transpositionTable.size() - 1)];
+  }
+
+public:
+  std::vector<S32> path;
+  U64 exploredNodes = 0;
+
+  Searcher(const SearchRules &searchRules, Iteration &currentIteration, std::size_t transpositionTableSize)
+      : rules(searchRules), iteration(currentIteration), transpositionTable(transpositionTableSize) {
+  }
+
+  void startTask(U64 newTask, const std::vector<S32> &taskPath) {
+    task = newTask;
+    aborted = false;
+    path = taskPath;
+  }
+
+  void collectTasksAt(S32 depth) {
+    splitDepth = depth;
+  }
+
+  /**
+   * Returns whether or not a solution was found under the node, leaving its clicks in the path.
+   */
+  bool search(const Node &node, S32 depth) {
+    const auto clicksLeft = rules.estimateClicks(node);
+    if (clicksLeft == PatternDatabase::Unsolvable) {
+      return false;
+    }
+    const auto estimate = depth + clicksLeft;
+    if (estimate > iteration.bound) {
+      iteration.lowerNextBound(estimate);
+      return false;
+    }
+    exploredNodes++;
+    if (node.board.isSolved()) {
+      return true;
+    }
+    if (rules.isUnsolvable(node)) {
+      return false;
+    }
+    if (splitDepth && depth == *splitDepth) {
+      iteration.tasks.push_back({node, path});
+      return false;
+    }
+    if (iteration.bestTask.load(std::memory_order_relaxed) < task) {
+      aborted = true;
+      return false;
+    }
+    auto *entry = findTranspositionEntry(node);
+    // A node reached again with at most as many clicks left was already searched without success.
+    if (entry != nullptr && entry->iteration == iteration.number && entry->board == node.board &&
+        entry->clicked == getTranspositionKey(node) && entry->clickableAgain == node.clickableAgain &&
+        entry->depth <= depth) {
+      return false;
+    }
+    ClickList clicks{};
+    const auto clickCount = rules.listClicks(node, clicks);
+    for (S32 i = 0; i < clickCount; i++) {
+      const auto index = clicks[i];
+      auto child = node;
+      child.board.activate(rules.layout, index);
+      if (rules.limitingRepeatedClicks) {
+        if ((node.clicked & bitOf(index)) != 0) {
+          child.clickableAgain &= ~bitOf(index);
+        } else if ((rules.clickReaches[index] & ~bitOf(index) & node.board.blocked) != 0) {
+          child.clickableAgain |= bitOf(index);
+        }
+      }
+      child.clicked |= bitOf(index);
+      child.firstClickableIndex = index + 1;
+      path.push_back(index);
+      if (search(child, depth + 1)) {
+        return true;
+      }
+      path.pop_back();
+      if (aborted) {
+        return false;
+      }
+    }
+    // Only subtrees which were searched completely may be skipped later.
+    if (entry != nullptr) {
+      *entry = {node.board, getTranspositionKey(node), node.clickableAgain, iteration.number, depth};
+    }
+    return false;
+  }
+};
+
+/**
+ * A deque of task indices per thread. Threads take their own tasks from the front and steal from the back.
+ */
+class TaskQueues {
+  class Queue {
+  public:
+    std::mutex mutex;
+    std::deque<U64> tasks;
+  };
+
+  std::vector<Queue> queues;
+
+public:
+  TaskQueues(U32 threadCount, U64 taskCount) : queues(threadCount) {
+    for (U32 thread = 0; thread < threadCount; thread++) {
+      const auto first = taskCount * thread / threadCount;
+      const auto last = taskCount * (thread + 1) / threadCount;
+      for (auto task = first; task < last; task++) {
+        queues[thread].tasks.push_back(task);
+      }
+    }
+  }
+
+  std::optional<U64> take(U32 thread) {
+    {
+      const std::lock_guard<std::mutex> lock(queues[thread].mutex);
+      if (!queues[thread].tasks.empty()) {
+        const auto task = queues[thread].tasks.front();
+        queues[thread].tasks.pop_front();
+        return task;
+      }
+    }
+    for (U32 offset = 1; offset < queues.size(); offset++) {
+      auto &victim = queues[(thread + offset) % queues.size()];
+      const std::lock_guard<std::mutex> lock(victim.mutex);
+      if (!victim.tasks.empty()) {
+        const auto task = victim.tasks.back();
+        victim.tasks.pop_back();
+        return task;
+      }
+    }
+    return std::nullopt;
+  }
+};
+} // namespace
+
+IterativeDeepeningEngine::IterativeDeepeningEngine(const SolverConfiguration &configuration)
+    : solverConfiguration(configuration) {
+}
+
+bool IterativeDeepeningEngine::canSolve(const Board &board) const {
+  const BoardLayout layout(board);
+  return layout.canBePacked();
+}
+
+Solution IterativeDeepeningEngine::findSolution(const Board &board) const {
+  if (!canSolve(board)) {
+    const auto limitString = std::to_string(BoardLayout::MaximumPackedTileCount);
+    throw std::invalid_argument("Iterative deepening supports components of at most " + limitString + " tiles.");
+  }
+  const BoardLayout layout(board);
+  const auto tileCount = layout.getTileCount();
+  SearchRules rules(layout);
+  rules.directional = board.canBeSolvedOptimallyDirectionally();
+  rules.flippingOnlyUp = solverConfiguration.isFlippingOnlyUp();
+  rules.orderingClicksCanonically =
+      !board.mayNeedMultipleClicks() && !rules.directional && !rules.flippingOnlyUp && board.hasCommutativeClicks();
+  // As in the breadth-first search, a tile is only clicked again if its first click unblocked a tile, unless there are
+  // twins, whose clicks depend on their state.
+  rules.limitingRepeatedClicks = !rules.orderingClicksCanonically && layout.getTwinMask() == 0;
+  rules.clickReaches = layout.computeClickReaches();
+  auto hasChains = false;
+  for (S32 index = 0; index < tileCount; index++) {
+    hasChains = hasChains || layout.getType(index) == TileType::Chain;
+  }
+  rules.estimatingClicks = !hasChains;
+  if (solverConfiguration.isUsingPatternDatabases() && PatternDatabase::canBeBuilt(layout)) {
+    const auto &directory = solverConfiguration.getPatternDatabaseDirectory();
+    rules.patternDatabase =
+        directory.empty() ? PatternDatabase::build(layout) : PatternDatabase::loadOrBuild(layout, directory);
+  }
+  if (rules.orderingClicksCanonically && !hasChains && layout.getTwinMask() == 0) {
+    // A tile can only be changed by clicking it or one of its neighbors.
+    rules.unreachableMasks.resize(tileCount + 1);
+    for (S32 index = 0; index < tileCount; index++) {
+      auto lastAffectingIndex = index;
+      for (const auto neighbor : layout.getNeighbors(index)) {
+        lastAffectingIndex = std::max(lastAffectingIndex, neighbor);
+      }
+      for (auto firstClickableIndex = lastAffectingIndex + 1; firstClickableIndex <= tileCount; firstClickableIndex++) {
+        rules.unreachableMasks[firstClickableIndex] |= bitOf(index);
+      }
+    }
+  }
+  Node root{PackedBoard(layout, board), 0, 0, 0};
+  std::vector<S32> rootPath;
+  for (const auto index : layout.findRaisedTaps(root.board.up)) {
+    root.board.activate(layout, index);
+    root.clicked |= bitOf(index);
+    rootPath.push_back(index);
+  }
+  const auto threadCount = std::max(1u, solverConfiguration.getThreadCount());
+  // Clicks in canonical order never reach a board twice, and what may be clicked next depends on more than the board.
+  const auto tableSize = rules.orderingClicksCanonically ? 0 : solverConfiguration.getTranspositionTableSize();
+  const auto tableSizePerThread = std::bit_floor(tableSize / threadCount);
+  // With repeated clicks the search space never runs out, so it is limited to two clicks per tile. When repeated clicks
+  // are limited, only tiles which reach a blocked tile other than themselves may be clicked twice.
+  auto maximumDepth = board.mayNeedMultipleClicks() ? 2 * tileCount : tileCount;
+  if (rules.limitingRepeatedClicks) {
+    maximumDepth = tileCount;
+    for (S32 index = 0; index < tileCount; index++) {
+      if ((rules.clickReaches[index] & ~bitOf(index) & root.board.blocked) != 0) {
+        maximumDepth++;
+      }
+    }
+  }
+  const auto rootDepth = static_cast<S32>(rootPath.size());
+  U64 exploredNodes = 0;
+  Iteration iteration;
+  const auto rootClicksLeft = rules.estimateClicks(root);
+  if (rootClicksLeft == PatternDatabase::Unsolvable) {
+    throw std::runtime_error("Could not find a solution after exploring 0 nodes.");
+  }
+  iteration.bound = rootDepth + rootClicksLeft;
+  while (true) {
+    iteration.number++;
+    iteration.tasks.clear();
+    iteration.nextBound = NoBound;
+    iteration.bestTask = NoTask;
+    // The tree is split at increasing depths until there are enough subtrees for every thread to have a few.
+    std::optional<std::vector<S32>> solutionPath;
+    Searcher splitter(rules, iteration, 0);
+    if (threadCount == 1) {
+      iteration.tasks.push_back({root, rootPath});
+    }
+    for (auto splitDepth = rootDepth + 1; threadCount > 1; splitDepth++) {
+      iteration.tasks.clear();
+      iteration.nextBound = NoBound;
+      splitter.startTask(0, rootPath);
+      splitter.collectTasksAt(splitDepth);
+      if (splitter.search(root, rootDepth)) {
+        solutionPath = splitter.path;
+        break;
+      }
+      if (iteration.tasks.size() >= threadCount * TasksPerThread || splitDepth >= iteration.bound) {
+        break;
+      }
+    }
+    exploredNodes += splitter.exploredNodes;
+    if (!solutionPath) {
+      TaskQueues taskQueues(threadCount, iteration.tasks.size());
+      std::vector<U64> exploredNodesPerThread(threadCount);
+      const auto work = [&](U32 thread) {
+        Searcher searcher(rules, iteration, tableSizePerThread);
+        while (const auto task = taskQueues.take(thread)) {
+          if (iteration.bestTask.load(std::memory_order_relaxed) < *task) {
+            continue;
+          }
+          searcher.startTask(*task, iteration.tasks[*task].path);
+          if (searcher.search(iteration.tasks[*task].node, static_cast<S32>(iteration.tasks[*task].path.size()))) {
+            iteration.offerSolution(*task, searcher.path);
+          }
+        }
+        exploredNodesPerThread[thread] = searcher.exploredNodes;
+      };
+      if (threadCount == 1) {
+        work(0);
+      } else {
+        std::vector<std::thread> workers;
+        for (U32 thread = 0; thread < threadCount; thread++) {
+          workers.emplace_back(work, thread);
+        }
+        for (auto &worker : workers) {
+          worker.join();
+        }
+      }
+      for (const auto threadExploredNodes : exploredNodesPerThread) {
+        exploredNodes += threadExploredNodes;
+      }
+      if (iteration.bestTask.load() != NoTask) {
+        solutionPath = iteration.solutionPath;
+      }
+    }
+    if (solutionPath) {
+      std::vector<Position> clicks;
+      for (const auto index : *solutionPath) {
+        clicks.push_back(layout.getPosition(index));
+      }
+      Solution solution(clicks, !rules.flippingOnlyUp);
+      solution.setExploredNodes(exploredNodes);
+      // The only boards this engine remembers are those in the transposition tables, which never grow.
+      solution.getMemoryBreakdown().seenBoardBytes = threadCount * tableSizePerThread * sizeof(TranspositionEntry);
+      return solution;
+    }
+    const auto exploredNodeCount = toPluralizedString(exploredNodes, "node");
+    if (iteration.nextBound.load() == NoBound) {
+      throw std::runtime_error("Could not find a solution after exploring " + exploredNodeCount + ".");
+    }
+    if (iteration.nextBound.load() > maximumDepth) {
+      const auto clickCount = toPluralizedString(maximumDepth, "click");
+      throw std::runtime_error("Could not find a solution with at most " + clickCount + " after exploring " +
+                               exploredNodeCount + ".");
+    }
+    iteration.bound = iteration.nextBound.load();
+  }
+}
+} // namespace WayoutPlayer
@@ -0,0 +1,28 @@
+#pragma once
+
+#include "Board.hpp"
+#include "Solution.hpp"
+#include "SolverConfiguration.hpp"
+
+namespace WayoutPlayer {
+/**
+ * Finds minimum solutions by iterative-deepening A*, using memory linear in the length of the solution.
+ *
+ * Every iteration splits the search tree at a shallow depth into subtrees which are distributed across the threads.
+ * Threads which run out of subtrees steal them from the others. The first solution found within the bound of an
+ * iteration is optimal, so all threads stop as soon as one is found.
+ */
+class IterativeDeepeningEngine {
+  const SolverConfiguration &solverConfiguration;
+
+public:
+  explicit IterativeDeepeningEngine(const SolverConfiguration &configuration);
+
+  /**
+   * Returns whether or not this engine can solve the board.
+   */
+  [[nodiscard]] bool canSolve(const Board &board) const;
+
+  [[nodiscard]] Solution findSolution(const Board &board) const;
+};
+} // namespace WayoutPlayer
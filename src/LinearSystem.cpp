@@ -0,0 +1,83 @@
+#include "LinearSystem.hpp"
+
+#include <bit>
+#include <stdexcept>
+#include <utility>
+
+namespace WayoutPlayer {
+LinearSystem::LinearSystem(std::vector<U64> columnVector) : columns(std::move(columnVector)) {
+  if (columns.size() > 64) {
+    throw std::invalid_argument("Linear systems support at most 64 unknowns.");
+  }
+  for (std::size_t k = 0; k < columns.size(); k++) {
+    auto column = columns[k];
+    const auto combination = reduce(column) ^ (U64{1} << k);
+    if (column == 0) {
+      nullSpaceBasis.push_back(combination);
+    } else {
+      pivots[63 - std::countl_zero(column)] = Pivot{column, combination};
+    }
+  }
+}
+
+U64 LinearSystem::reduce(U64 &column) const {
+  U64 combination = 0;
+  while (column != 0) {
+    const auto &pivot = pivots[63 - std::countl_zero(column)];
+    if (!pivot) {
+      // Lower bits may still be reducible, but a nonzero column can no longer become zero.
+      break;
+    }
+    column ^= pivot->column;
+    combination ^= pivot->combination;
+  }
+  return combination;
+}
+
+const std::vector<U64> &LinearSystem::getColumns() const {
+  return columns;
+}
+
+U32 LinearSystem::getRank() const {
+  return static_cast<U32>(columns.size() - nullSpaceBasis.size());
+}
+
+const std::vector<U64> &LinearSystem::getNullSpaceBasis() const {
+  return nullSpaceBasis;
+}
+
+std::optional<U64> LinearSystem::solve(U64 rightHandSide) const {
+  auto column = rightHandSide;
+  const auto combination = reduce(column);
+  if (column != 0) {
+    return std::nullopt;
+  }
+  return combination;
+}
+
+std::optional<U64> LinearSystem::solveWithFewestUnknowns(U64 rightHandSide) const {
+  const auto particularSolution = solve(rightHandSide);
+  if (!particularSolution) {
+    return std::nullopt;
+  }
+  auto bestSolution = *particularSolution;
+  auto solution = bestSolution;
+  // Every solution is visited once by adding one basis vector at a time in Gray code order.
+  const auto solutionCount = U64{1} << nullSpaceBasis.size();
+  for (U64 step = 1; step < solutionCount; step++) {
+    solution ^= nullSpaceBasis[std::countr_zero(step)];
+    if (std::popcount(solution) < std::popcount(bestSolution)) {
+      bestSolution = solution;
+    }
+  }
+  return bestSolution;
+}
+
+U64 LinearSystem::evaluate(U64 solution) const {
+  U64 result = 0;
+  for (auto remaining = solution; remaining != 0; remaining &= remaining - 1) {
+    result ^= columns[std::countr_zero(remaining)];
+  }
+  return result;
+}
+} // namespace WayoutPlayer
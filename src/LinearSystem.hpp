@@ -0,0 +1,65 @@
+#pragma once
+
+#include <array>
+#include <optional>
+#include <vector>
+
+#include "Types.hpp"
+
+namespace WayoutPlayer {
+/**
+ * A system of linear equations over GF(2) with at most 64 unknowns and 64 equations, stored as bit masks.
+ *
+ * Bit k of a solution says whether unknown k is set, and column k says which equations unknown k appears in. On boards
+ * with commutative clicks the unknowns are the tiles which may be clicked and the columns are their click effects.
+ */
+class LinearSystem {
+  class Pivot {
+  public:
+    U64 column = 0;
+    // Which columns were added together to make this one.
+    U64 combination = 0;
+  };
+
+  std::vector<U64> columns;
+  // Indexed by the highest bit of the reduced column, so that reducing from the highest bit down needs no search.
+  std::array<std::optional<Pivot>, 64> pivots;
+  std::vector<U64> nullSpaceBasis;
+
+  /**
+   * Reduces the column by the pivots and returns the combination of columns that was added to it.
+   */
+  U64 reduce(U64 &column) const;
+
+public:
+  explicit LinearSystem(std::vector<U64> columnVector);
+
+  [[nodiscard]] const std::vector<U64> &getColumns() const;
+
+  [[nodiscard]] U32 getRank() const;
+
+  /**
+   * Returns solutions of the homogeneous system such that every solution of it is a sum of some of them.
+   *
+   * Adding any of them to a solution gives another solution, and all solutions can be reached that way.
+   */
+  [[nodiscard]] const std::vector<U64> &getNullSpaceBasis() const;
+
+  /**
+   * Returns a solution of the system with the given right-hand side, or nothing if it has none.
+   */
+  [[nodiscard]] std::optional<U64> solve(U64 rightHandSide) const;
+
+  /**
+   * Returns a solution with the fewest unknowns set, or nothing if there is none.
+   *
+   * Every solution is visited, so this takes time exponential in the size of the null space basis.
+   */
+  [[nodiscard]] std::optional<U64> solveWithFewestUnknowns(U64 rightHandSide) const;
+
+  /**
+   * Returns the right-hand side of the system for the solution.
+   */
+  [[nodiscard]] U64 evaluate(U64 solution) const;
+};
+} // namespace WayoutPlayer
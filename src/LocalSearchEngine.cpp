@@ -0,0 +1,410 @@
+#include "LocalSearchEngine.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <chrono>
+#include <cmath>
+#include <functional>
+#include <memory_resource>
+#include <optional>
+#include <queue>
+#include <random>
+#include <stdexcept>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+
+#include "Arena.hpp"
+#include "Bits.hpp"
+#include "BoardLayout.hpp"
+#include "LinearSystem.hpp"
+#include "PackedBoard.hpp"
+#include "Text.hpp"
+
+namespace WayoutPlayer {
+namespace {
+// Walking all 2^20 solutions takes a few milliseconds, which is less than annealing needs to be useful.
+constexpr std::size_t MaximumEnumeratedNullity = 20;
+// Temperatures at which making a solution one click longer is accepted with probability 0.6 and 2e-9.
+constexpr F64 InitialTemperature = 2.0;
+constexpr F64 FinalTemperature = 0.05;
+constexpr U64 StepsPerClockCheck = 1024;
+constexpr U64 RandomSeed = 36;
+// How many clicks the greedy search would rather make to have one fewer raised or blocked tile, by attempt. The first
+// attempt is the fastest, and later ones make shorter solutions while the time budget allows.
+constexpr std::array<S32, 2> GreedyWeights = {2, 1};
+
+using Clock = std::chrono::steady_clock;
+
+S32 countClicks(U64 clicks) {
+  return std::popcount(clicks);
+}
+
+/**
+ * Replaces up to three clicks of a set by a smaller set of clicks with the same effect.
+ */
+class ClickSetImprover {
+  const std::vector<U64> &effects;
+  // The first set of at most two clicks found for every effect, so smaller sets are preferred.
+  std::unordered_map<U64, U64> smallestSetByEffect;
+  // Sets of at most four clicks which have no effect, found when two small sets have the same effect.
+  std::vector<U64> shortNullSets;
+
+  void addSet(U64 effect, U64 clicks) {
+    const auto [iterator, inserted] = smallestSetByEffect.emplace(effect, clicks);
+    if (!inserted) {
+      shortNullSets.push_back(iterator->second ^ clicks);
+    }
+  }
+
+  [[nodiscard]] std::optional<U64> replace(U64 clicks, U64 removed, U64 effect) const {
+    const auto iterator = smallestSetByEffect.find(effect);
+    if (iterator == smallestSetByEffect.end()) {
+      return std::nullopt;
+    }
+    const auto candidate = clicks ^ removed ^ iterator->second;
+    if (countClicks(candidate) >= countClicks(clicks)) {
+      return std::nullopt;
+    }
+    return candidate;
+  }
+
+  [[nodiscard]] std::optional<U64> findShorterSet(U64 clicks) const {
+    std::vector<S32> members;
+    for (auto remaining = clicks; remaining != 0; remaining &= remaining - 1) {
+      members.push_back(std::countr_zero(remaining));
+    }
+    const auto memberCount = members.size();
+    for (std::size_t a = 0; a < memberCount; a++) {
+      const auto setA = bitOf(members[a]);
+      const auto effectA = effects[members[a]];
+      if (const auto candidate = replace(clicks, setA, effectA)) {
+        return candidate;
+      }
+      for (auto b = a + 1; b < memberCount; b++) {
+        const auto setAB = setA | bitOf(members[b]);
+        const auto effectAB = effectA ^ effects[members[b]];
+        if (const auto candidate = replace(clicks, setAB, effectAB)) {
+          return candidate;
+        }
+        for (auto c = b + 1; c < memberCount; c++) {
+          if (const auto candidate = replace(clicks, setAB | bitOf(members[c]), effectAB ^ effects[members[c]])) {
+            return candidate;
+          }
+        }
+      }
+    }
+    return std::nullopt;
+  }
+
+public:
+  explicit ClickSetImprover(const std::vector<U64> &effectVector) : effects(effectVector) {
+    const auto n = static_cast<S32>(effects.size());
+    addSet(0, 0);
+    for (S32 a = 0; a < n; a++) {
+      addSet(effects[a], U64{1} << static_cast<U32>(a));
+    }
+    for (S32 a = 0; a < n; a++) {
+      for (S32 b = a + 1; b < n; b++) {
+        addSet(effects[a] ^ effects[b], (U64{1} << static_cast<U32>(a)) | (U64{1} << static_cast<U32>(b)));
+      }
+    }
+  }
+
+  [[nodiscard]] const std::vector<U64> &getShortNullSets() const {
+    return shortNullSets;
+  }
+
+  /**
+   * Applies replacements until none makes the set smaller.
+   */
+  [[nodiscard]] U64 descend(U64 clicks) const {
+    while (const auto candidate = findShorterSet(clicks)) {
+      clicks = *candidate;
+    }
+    return clicks;
+  }
+};
+/**
+ * Finds a solution by best-first search, preferring boards with few raised and blocked tiles to boards with few clicks.
+ *
+ * Returns nothing if the deadline passes first.
+ */
+std::optional<Solution> findSolutionGreedily(const BoardLayout &layout, const Board &board, S32 weight,
+                                             std::size_t maximumBoardHashTableSize,
+                                             Clock::time_point deadline) {
+  Arena arena(getThreadCacheResource());
+  CountingMemoryResource pathResource(arena.getResource());
+  CountingMemoryResource frontierResource(arena.getResource());
+  class SearchNode {
+  public:
+    PackedBoard board;
+    U32 parent = 0;
+    S32 index = -1;
+    S32 depth = 0;
+  };
+  std::pmr::vector<SearchNode> nodes(&pathResource);
+  const auto getClickPositionVector = [&layout, &nodes](U32 node) {
+    std::vector<Position> clicks;
+    for (; node != 0; node = nodes[node].parent) {
+      clicks.push_back(layout.getPosition(nodes[node].index));
+    }
+    std::reverse(std::begin(clicks), std::end(clicks));
+    return clicks;
+  };
+  struct Hash {
+    std::size_t operator()(const PackedBoard &packedBoard) const {
+      return packedBoard.hash();
+    }
+  };
+  std::pmr::unordered_set<PackedBoard, Hash> seenBoards(arena.getResource());
+  // Ties go to the board found first.
+  using Entry = std::pair<S32, U32>;
+  std::pmr::vector<Entry> queueStorage(&frontierResource);
+  std::priority_queue<Entry, std::pmr::vector<Entry>, std::greater<>> queue(std::greater<>(), std::move(queueStorage));
+  const auto push = [&](const PackedBoard &packedBoard, U32 parent, S32 index, S32 depth) {
+    if (!seenBoards.insert(packedBoard).second) {
+      return;
+    }
+    nodes.push_back({packedBoard, parent, index, depth});
+    const auto remaining = std::popcount(packedBoard.up) + std::popcount(packedBoard.blocked);
+    queue.emplace(depth + weight * remaining, static_cast<U32>(nodes.size() - 1));
+  };
+  auto initialBoard = PackedBoard(layout, board);
+  nodes.push_back({initialBoard, 0, -1, 0});
+  U32 initialNode = 0;
+  for (const auto index : layout.findRaisedTaps(initialBoard.up)) {
+    initialBoard.activate(layout, index);
+    nodes.push_back({initialBoard, initialNode, index, nodes[initialNode].depth + 1});
+    initialNode = static_cast<U32>(nodes.size() - 1);
+  }
+  seenBoards.insert(initialBoard);
+  queue.emplace(0, initialNode);
+  U64 exploredNodes = 0;
+  while (!queue.empty()) {
+    const auto nodeIndex = queue.top().second;
+    queue.pop();
+    const auto node = nodes[nodeIndex];
+    if (node.board.isSolved()) {
+      Solution solution(getClickPositionVector(nodeIndex), false);
+      auto &memoryBreakdown = solution.getMemoryBreakdown();
+      memoryBreakdown.frontierBytes = frontierResource.getPeakBytes();
+      memoryBreakdown.seenBoardBytes = estimateHashSetBytes(seenBoards);
+      memoryBreakdown.pathBytes = pathResource.getPeakBytes();
+      solution.setExploredNodes(exploredNodes);
+      solution.setDistinctNodes(seenBoards.size());
+      return solution;
+    }
+    if (seenBoards.size() > maximumBoardHashTableSize) {
+      const auto limitString = std::to_string(maximumBoardHashTableSize);
+      throw std::runtime_error("Board hash table size exceeded the limit of " + limitString + ".");
+    }
+    if (exploredNodes % StepsPerClockCheck == 0 && Clock::now() >= deadline) {
+      return std::nullopt;
+    }
+    exploredNodes++;
+    for (S32 index = 0; index < layout.getTileCount(); index++) {
+      const auto type = node.board.getType(layout, index);
+      if (type == TileType::Tap || type == TileType::Blocked) {
+        continue;
+      }
+      auto derivedBoard = node.board;
+      derivedBoard.activate(layout, index);
+      push(derivedBoard, nodeIndex, index, node.depth + 1);
+    }
+  }
+  const auto exploredNodeCount = toPluralizedString(exploredNodes, "node");
+  throw std::runtime_error("Could not find a solution after exploring " + exploredNodeCount + ".");
+}
+
+} // namespace
+
+LocalSearchEngine::LocalSearchEngine(const SolverConfiguration &configuration) : solverConfiguration(configuration) {
+}
+
+bool LocalSearchEngine::canSolve(const Board &board) const {
+  const BoardLayout layout(board);
+  return layout.canBePacked();
+}
+
+Solution LocalSearchEngine::findSolution(const Board &board) const {
+  if (!canSolve(board)) {
+    const auto limitString = std::to_string(BoardLayout::MaximumPackedTileCount);
+    throw std::invalid_argument("Local search supports components of at most " + limitString + " tiles.");
+  }
+  if (board.isSolved()) {
+    return Solution({}, true);
+  }
+  if (board.hasCommutativeClicks()) {
+    return findSolutionAlgebraically(board);
+  }
+  const BoardLayout layout(board);
+  const auto deadline = Clock::now() + solverConfiguration.getLocalSearchTimeBudget();
+  const auto maximumBoardHashTableSize = solverConfiguration.getMaximumBoardHashTableSize();
+  std::optional<Solution> bestSolution;
+  // Every attempt and the shortening of the best solution share the time budget.
+  for (const auto weight : GreedyWeights) {
+    const auto solution = findSolutionGreedily(layout, board, weight, maximumBoardHashTableSize, deadline);
+    if (!solution) {
+      break;
+    }
+    if (!bestSolution || solution->getClicks().size() < bestSolution->getClicks().size()) {
+      bestSolution = solution;
+    }
+  }
+  if (!bestSolution) {
+    throw std::runtime_error("Could not find a solution within the time budget.");
+  }
+  return improveSolution(board, *bestSolution, deadline);
+}
+
+Solution LocalSearchEngine::findSolutionAlgebraically(const Board &board) const {
+  const BoardLayout layout(board);
+  const auto allEffects = layout.computeClickEffects(board);
+  std::vector<Position> forcedClicks;
+  auto target = layout.getUpMask(board);
+  for (const auto index : layout.findRaisedTaps(target)) {
+    forcedClicks.push_back(layout.getPosition(index));
+    target ^= allEffects[index];
+  }
+  std::vector<S32> freeIndices;
+  for (S32 index = 0; index < layout.getTileCount(); index++) {
+    if (layout.getType(index) != TileType::Tap) {
+      freeIndices.push_back(index);
+    }
+  }
+  std::vector<U64> effects;
+  for (const auto index : freeIndices) {
+    effects.push_back(allEffects[index]);
+  }
+  const LinearSystem system(effects);
+  const auto particularSolution = system.solve(target);
+  if (!particularSolution) {
+    throw std::runtime_error("The board has no solution.");
+  }
+  const auto &nullSpaceBasis = system.getNullSpaceBasis();
+  auto bestClicks = *particularSolution;
+  U64 exploredNodes = 1;
+  const auto optimal = nullSpaceBasis.size() <= MaximumEnumeratedNullity;
+  if (optimal) {
+    bestClicks = *system.solveWithFewestUnknowns(target);
+    exploredNodes = U64{1} << nullSpaceBasis.size();
+  } else {
+    const ClickSetImprover improver(effects);
+    auto moves = nullSpaceBasis;
+    const auto &shortNullSets = improver.getShortNullSets();
+    moves.insert(moves.end(), shortNullSets.begin(), shortNullSets.end());
+    auto clicks = improver.descend(bestClicks);
+    bestClicks = clicks;
+    std::mt19937_64 generator(RandomSeed);
+    std::uniform_real_distribution<F64> uniform(0.0, 1.0);
+    const auto budget = std::chrono::duration<F64>(solverConfiguration.getLocalSearchTimeBudget());
+    const auto start = Clock::now();
+    auto temperature = InitialTemperature;
+    for (U64 step = 0;; step++) {
+      if (step % StepsPerClockCheck == 0) {
+        const auto fraction = (Clock::now() - start) / budget;
+        if (fraction >= 1.0) {
+          break;
+        }
+        temperature = InitialTemperature * std::pow(FinalTemperature / InitialTemperature, fraction);
+      }
+      const auto candidate = clicks ^ moves[generator() % moves.size()];
+      const auto delta = countClicks(candidate) - countClicks(clicks);
+      if (delta <= 0 || uniform(generator) < std::exp(-delta / temperature)) {
+        clicks = candidate;
+        if (countClicks(clicks) < countClicks(bestClicks)) {
+          bestClicks = clicks;
+        }
+      }
+      exploredNodes++;
+    }
+    bestClicks = improver.descend(bestClicks);
+  }
+  auto clicks = forcedClicks;
+  for (auto remaining = bestClicks; remaining != 0; remaining &= remaining - 1) {
+    clicks.push_back(layout.getPosition(freeIndices[std::countr_zero(remaining)]));
+  }
+  Solution solution(clicks, optimal);
+  solution.setExploredNodes(exploredNodes);
+  return solution;
+}
+
+Solution LocalSearchEngine::improveSolution(const Board &board, const Solution &solution) const {
+  return improveSolution(board, solution, Clock::now() + solverConfiguration.getLocalSearchTimeBudget());
+}
+
+Solution LocalSearchEngine::improveSolution(const Board &board, const Solution &solution,
+                                            Clock::time_point deadline) const {
+  const BoardLayout layout(board);
+  if (!layout.canBePacked()) {
+    const auto limitString = std::to_string(BoardLayout::MaximumPackedTileCount);
+    throw std::invalid_argument("Local search supports components of at most " + limitString + " tiles.");
+  }
+  const PackedBoard initialBoard(layout, board);
+  std::vector<S32> clicks;
+  for (const auto &position : solution.getClicks()) {
+    clicks.push_back(*layout.getIndex(position.i, position.j));
+  }
+  U64 exploredNodes = 0;
+  const auto solves = [&layout, &initialBoard, &exploredNodes](const std::vector<S32> &candidate) {
+    exploredNodes++;
+    auto packedBoard = initialBoard;
+    for (const auto index : candidate) {
+      if (packedBoard.getType(layout, index) == TileType::Blocked) {
+        return false;
+      }
+      packedBoard.activate(layout, index);
+    }
+    return packedBoard.isSolved();
+  };
+  // Clicks do not commute here, so every candidate is checked by replaying it.
+  const auto findShorterSequence = [&clicks, &solves, deadline]() -> std::optional<std::vector<S32>> {
+    const auto n = clicks.size();
+    const auto without = [&clicks](std::size_t a, std::size_t b, std::size_t c) {
+      std::vector<S32> candidate;
+      for (std::size_t k = 0; k < clicks.size(); k++) {
+        if (k != a && k != b && k != c) {
+          candidate.push_back(clicks[k]);
+        }
+      }
+      return candidate;
+    };
+    for (std::size_t a = 0; a < n; a++) {
+      if (Clock::now() >= deadline) {
+        return std::nullopt;
+      }
+      for (auto b = a; b < n; b++) {
+        for (auto c = b; c < n; c++) {
+          if (a == b && b != c) {
+            // Removing a and c is tried as (a, c, c).
+            continue;
+          }
+          auto candidate = without(a, b, c);
+          if (solves(candidate)) {
+            return candidate;
+          }
+        }
+      }
+    }
+    return std::nullopt;
+  };
+  while (auto candidate = findShorterSequence()) {
+    clicks = std::move(*candidate);
+  }
+  std::vector<Position> positions;
+  for (const auto index : clicks) {
+    positions.push_back(layout.getPosition(index));
+  }
+  Solution improvedSolution(positions, solution.isOptimal());
+  improvedSolution.setExploredNodes(solution.getExploredNodes().value_or(0) + exploredNodes);
+  if (solution.getDistinctNodes()) {
+    improvedSolution.setDistinctNodes(*solution.getDistinctNodes());
+  }
+  if (!solution.getMemoryBreakdowns().empty()) {
+    improvedSolution.getMemoryBreakdown() = solution.getMemoryBreakdowns().back();
+  }
+  return improvedSolution;
+}
+} // namespace WayoutPlayer
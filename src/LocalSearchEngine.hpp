@@ -0,0 +1,43 @@
+#pragma once
+
+#include <chrono>
+
+#include "Board.hpp"
+#include "Solution.hpp"
+#include "SolverConfiguration.hpp"
+
+namespace WayoutPlayer {
+/**
+ * Finds short solutions quickly by improving a first solution for as long as the configured time budget allows.
+ *
+ * On boards with commutative clicks a solution is a set of clicks, and all of them are obtained by adding sets of
+ * clicks without effect to one found by elimination. Clicks are replaced by smaller sets with the same effect until
+ * that is no longer possible, and simulated annealing adds sets without effect to escape from local minima. When there
+ * are few enough sets without effect, all solutions are tried and the shortest one is optimal.
+ *
+ * On other boards the first solution is found by a greedy best-first search and then shortened by removing clicks.
+ */
+class LocalSearchEngine {
+  const SolverConfiguration &solverConfiguration;
+
+  [[nodiscard]] Solution findSolutionAlgebraically(const Board &board) const;
+
+  [[nodiscard]] Solution improveSolution(const Board &board, const Solution &solution,
+                                         std::chrono::steady_clock::time_point deadline) const;
+
+public:
+  explicit LocalSearchEngine(const SolverConfiguration &configuration);
+
+  /**
+   * Returns whether or not this engine can solve the board.
+   */
+  [[nodiscard]] bool canSolve(const Board &board) const;
+
+  [[nodiscard]] Solution findSolution(const Board &board) const;
+
+  /**
+   * Shortens a solution of any board by removing up to three clicks at a time while the rest still solves the board.
+   */
+  [[nodiscard]] Solution improveSolution(const Board &board, const Solution &solution) const;
+};
+} // namespace WayoutPlayer
@@ -0,0 +1,99 @@
+#include "PackedBoard.hpp"
+
+#include <stdexcept>
+
+#include "Bits.hpp"
+
+namespace WayoutPlayer {
+PackedBoard::PackedBoard(const BoardLayout &layout, const Board &board)
+    : up(layout.getUpMask(board)), blocked(layout.getBlockedMask(board)) {
+}
+
+TileType PackedBoard::getType(const BoardLayout &layout, S32 index) const {
+  if ((blocked & bitOf(index)) != 0) {
+    return TileType::Blocked;
+  }
+  const auto type = layout.getType(index);
+  return type == TileType::Blocked ? TileType::Default : type;
+}
+
+bool PackedBoard::isSolved() const {
+  return up == 0 && blocked == 0;
+}
+
+void PackedBoard::safeInvert(const BoardLayout &layout, S32 index, bool clicked, History &history) {
+  if (index < 0) {
+    return;
+  }
+  const auto bit = bitOf(index);
+  const auto type = getType(layout, index);
+  if (type == TileType::Tap) {
+    if (clicked) {
+      up ^= bit;
+      history.inverted |= bit;
+    }
+  } else if (type == TileType::Blocked) {
+    if (clicked) {
+      throw std::runtime_error("Cannot click on a blocked tile.");
+    }
+    blocked &= ~bit;
+  } else if (type == TileType::Chain) {
+    up ^= bit;
+    history.inverted |= bit;
+    // This will work as a default tile unless it was not clicked.
+    if (clicked) {
+      return;
+    }
+    for (const auto neighbor : layout.getNeighbors(index)) {
+      if (neighbor >= 0 && (history.inverted & bitOf(neighbor)) == 0) {
+        safeInvert(layout, neighbor, false, history);
+      }
+    }
+  } else if (type == TileType::Twin) {
+    if (!history.twinFinalState) {
+      history.twinFinalState = (up & bit) == 0;
+    }
+    up = *history.twinFinalState ? up | bit : up & ~bit;
+  } else {
+    up ^= bit;
+    history.inverted |= bit;
+  }
+}
+
+void PackedBoard::activate(const BoardLayout &layout, S32 index) {
+  const auto type = getType(layout, index);
+  const auto &neighbors = layout.getNeighbors(index);
+  History history;
+  safeInvert(layout, index, true, history);
+  if (type == TileType::Default || type == TileType::Tap || type == TileType::Chain || type == TileType::Twin) {
+    for (const auto neighbor : neighbors) {
+      safeInvert(layout, neighbor, false, history);
+    }
+  } else if (type == TileType::Horizontal) {
+    safeInvert(layout, neighbors[1], false, history);
+    safeInvert(layout, neighbors[2], false, history);
+  } else if (type == TileType::Vertical) {
+    safeInvert(layout, neighbors[0], false, history);
+    safeInvert(layout, neighbors[3], false, history);
+  } else if (type == TileType::Blocked) {
+    throw std::runtime_error("Cannot activate a blocked tile.");
+  } else {
+    throw std::invalid_argument("Did not match the tile type.");
+  }
+  if (history.twinFinalState) {
+    up = *history.twinFinalState ? up | layout.getTwinMask() : up & ~layout.getTwinMask();
+  }
+}
+
+std::size_t PackedBoard::hash() const {
+  return mixBits(up ^ mixBits(blocked));
+}
+
+bool PackedBoard::operator==(const PackedBoard &rhs) const {
+  return up == rhs.up && blocked == rhs.blocked;
+}
+
+bool PackedBoard::operator!=(const PackedBoard &rhs) const {
+  return !(rhs == *this);
+}
+} // namespace WayoutPlayer
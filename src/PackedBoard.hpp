@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstddef>
+#include <optional>
+
+#include "BoardLayout.hpp"
+#include "Types.hpp"
+
+namespace WayoutPlayer {
+/**
+ * The state of a board with at most 64 tiles as two bit planes indexed by a BoardLayout.
+ *
+ * The layout holds everything that does not change when tiles are clicked. A blocked tile becomes a default tile once
+ * it is unblocked.
+ */
+class PackedBoard {
+  class History {
+  public:
+    U64 inverted = 0;
+    std::optional<bool> twinFinalState;
+  };
+
+  void safeInvert(const BoardLayout &layout, S32 index, bool clicked, History &history);
+
+public:
+  U64 up = 0;
+  U64 blocked = 0;
+
+  PackedBoard() = default;
+
+  PackedBoard(const BoardLayout &layout, const Board &board);
+
+  [[nodiscard]] TileType getType(const BoardLayout &layout, S32 index) const;
+
+  [[nodiscard]] bool isSolved() const;
+
+  /**
+   * Clicks a tile, exactly as Board::activate does.
+   */
+  void activate(const BoardLayout &layout, S32 index);
+
+  [[nodiscard]] std::size_t hash() const;
+
+  bool operator==(const PackedBoard &rhs) const;
+
+  bool operator!=(const PackedBoard &rhs) const;
+};
+} // namespace WayoutPlayer
@@ -0,0 +1,282 @@
+#include "PatternDatabase.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <deque>
+#include <filesystem>
+#include <limits>
+#include <stdexcept>
+
+#include "Bits.hpp"
+#include "Filesystem.hpp"
+#include "Hashing.hpp"
+
+namespace WayoutPlayer {
+namespace {
+constexpr std::string_view Magic = "WOPPATDB";
+constexpr std::string_view FormatName = "Pattern database";
+constexpr U32 Version = 1;
+const std::string Extension = ".pdb";
+// Regions are taken from square blocks of the board, so that most neighbors of a tile are in its region.
+constexpr S32 BlockSide = 4;
+constexpr S32 MaximumRegionBitCount = 16;
+constexpr U8 UnsolvableClickCount = std::numeric_limits<U8>::max();
+
+/**
+ * Returns the indices of the tiles whose state clicking the tile may change, including itself.
+ */
+std::vector<S32> getAffectedTiles(const BoardLayout &layout, S32 index) {
+  const auto &neighbors = layout.getNeighbors(index);
+  std::vector<S32> affected{index};
+  const auto type = layout.getType(index);
+  if (type == TileType::Horizontal) {
+    affected.push_back(neighbors[1]);
+    affected.push_back(neighbors[2]);
+  } else if (type == TileType::Vertical) {
+    affected.push_back(neighbors[0]);
+    affected.push_back(neighbors[3]);
+  } else {
+    affected.insert(std::end(affected), std::begin(neighbors), std::end(neighbors));
+  }
+  affected.erase(std::remove(std::begin(affected), std::end(affected), -1), std::end(affected));
+  return affected;
+}
+
+/**
+ * Computes the minimum number of clicks on tiles of the region needed to clear every pattern of the region.
+ *
+ * The abstract state of a region is the up bits of its tiles followed by the blocked bits of its blocked tiles. Since
+ * clicks on tiles outside of the region are free and their blocked state is unknown, they are always allowed.
+ */
+std::vector<U8> computeClickCounts(const BoardLayout &layout, U64 upMask, U64 blockedMask) {
+  const auto upBitCount = std::popcount(upMask);
+  const auto stateCount = std::size_t{1} << static_cast<U32>(upBitCount + std::popcount(blockedMask));
+  const auto getUpBit = [upMask](S32 index) { return U64{1} << std::popcount(upMask & (bitOf(index) - 1)); };
+  const auto getBlockedBit = [upBitCount, blockedMask](S32 index) {
+    return U64{1} << (upBitCount + std::popcount(blockedMask & (bitOf(index) - 1)));
+  };
+  class Click {
+  public:
+    S32 index;
+    bool inRegion;
+    std::vector<S32> affected;
+  };
+  std::vector<Click> clicks;
+  for (S32 index = 0; index < layout.getTileCount(); index++) {
+    if (layout.getType(index) == TileType::Tap) {
+      continue;
+    }
+    auto affected = getAffectedTiles(layout, index);
+    const auto isOutside = [upMask](S32 tile) { return (upMask & bitOf(tile)) == 0; };
+    affected.erase(std::remove_if(std::begin(affected), std::end(affected), isOutside), std::end(affected));
+    if (!affected.empty()) {
+      clicks.push_back({index, (upMask & bitOf(index)) != 0, affected});
+    }
+  }
+  // The edges of the abstract state graph are reversed, so that a search from the cleared state finds every distance.
+  std::vector<std::vector<U32>> freePredecessors(stateCount);
+  std::vector<std::vector<U32>> paidPredecessors(stateCount);
+  for (std::size_t state = 0; state < stateCount; state++) {
+    for (const auto &click : clicks) {
+      if (click.inRegion && (blockedMask & bitOf(click.index)) != 0 && (state & getBlockedBit(click.index)) != 0) {
+        continue;
+      }
+      auto next = state;
+      for (const auto tile : click.affected) {
+        if ((blockedMask & bitOf(tile)) != 0 && (next & getBlockedBit(tile)) != 0) {
+          next &= ~getBlockedBit(tile);
+        } else if (tile == click.index || layout.getType(tile) != TileType::Tap) {
+          next ^= getUpBit(tile);
+        }
+      }
+      auto &predecessors = click.inRegion ? paidPredecessors : freePredecessors;
+      predecessors[next].push_back(static_cast<U32>(state));
+    }
+  }
+  std::vector<U8> clickCounts(stateCount, UnsolvableClickCount);
+  std::deque<U32> queue;
+  clickCounts[0] = 0;
+  queue.push_back(0);
+  while (!queue.empty()) {
+    const auto state = queue.front();
+    queue.pop_front();
+    for (const auto predecessor : freePredecessors[state]) {
+      if (clickCounts[predecessor] > clickCounts[state]) {
+        clickCounts[predecessor] = clickCounts[state];
+        queue.push_front(predecessor);
+      }
+    }
+    for (const auto predecessor : paidPredecessors[state]) {
+      if (clickCounts[predecessor] > clickCounts[state] + 1) {
+        clickCounts[predecessor] = clickCounts[state] + 1;
+        queue.push_back(predecessor);
+      }
+    }
+  }
+  return clickCounts;
+}
+
+std::string getCacheFilename(const BoardLayout &layout) {
+  std::string description = std::string(Magic) + std::to_string(Version);
+  description += " " + std::to_string(layout.getRowCount()) + " " + std::to_string(layout.getColumnCount());
+  for (S32 index = 0; index < layout.getTileCount(); index++) {
+    description += " " + layout.getPosition(index).toString() + tileTypeToCharacter(layout.getType(index));
+  }
+  return digestToHexadecimal(computeDigest(description)) + Extension;
+}
+} // namespace
+
+bool PatternDatabase::canBeBuilt(const BoardLayout &layout) {
+  if (!layout.canBePacked()) {
+    return false;
+  }
+  for (S32 index = 0; index < layout.getTileCount(); index++) {
+    const auto type = layout.getType(index);
+    if (type == TileType::Chain || type == TileType::Twin) {
+      return false;
+    }
+  }
+  return true;
+}
+
+PatternDatabase PatternDatabase::build(const BoardLayout &layout) {
+  if (!canBeBuilt(layout)) {
+    throw std::invalid_argument("Pattern databases cannot be built for boards with chains, twins or over 64 tiles.");
+  }
+  PatternDatabase patternDatabase;
+  for (S32 blockI = 0; blockI < layout.getRowCount(); blockI += BlockSide) {
+    for (S32 blockJ = 0; blockJ < layout.getColumnCount(); blockJ += BlockSide) {
+      Region region;
+      S32 bitCount = 0;
+      const auto finishRegion = [&]() {
+        if (bitCount > 0) {
+          region.clickCounts = computeClickCounts(layout, region.upMask, region.blockedMask);
+          region.prepareGathers();
+          patternDatabase.regions.push_back(std::move(region));
+        }
+        region = Region();
+        bitCount = 0;
+      };
+      for (auto i = blockI; i < std::min(blockI + BlockSide, layout.getRowCount()); i++) {
+        for (auto j = blockJ; j < std::min(blockJ + BlockSide, layout.getColumnCount()); j++) {
+          const auto index = layout.getIndex(i, j);
+          if (!index) {
+            continue;
+          }
+          const auto isBlocked = layout.getType(*index) == TileType::Blocked;
+          const auto tileBitCount = isBlocked ? 2 : 1;
+          if (bitCount + tileBitCount > MaximumRegionBitCount) {
+            finishRegion();
+          }
+          region.upMask |= bitOf(*index);
+          if (isBlocked) {
+            region.blockedMask |= bitOf(*index);
+          }
+          bitCount += tileBitCount;
+        }
+      }
+      finishRegion();
+    }
+  }
+  return patternDatabase;
+}
+
+PatternDatabase PatternDatabase::loadOrBuild(const BoardLayout &layout, const std::string &directory) {
+  const auto path = std::filesystem::path(directory) / getCacheFilename(layout);
+  if (std::filesystem::is_regular_file(path)) {
+    const MappedFile file(path.string());
+    return deserialize(file.getContents());
+  }
+  const auto patternDatabase = build(layout);
+  std::filesystem::create_directories(directory);
+  // Concurrent solvers may build the same tables.
+  replaceFile(path.string(), patternDatabase.serialize());
+  return patternDatabase;
+}
+
+PatternDatabase PatternDatabase::deserialize(std::string_view bytes) {
+  if (!bytes.starts_with(Magic)) {
+    throw std::invalid_argument("Not a pattern database.");
+  }
+  std::size_t offset = Magic.size();
+  if (readInteger<U32>(bytes, offset, FormatName) != Version) {
+    throw std::invalid_argument("Unsupported pattern database version.");
+  }
+  offset += sizeof(U32);
+  const auto regionCount = readInteger<U32>(bytes, offset, FormatName);
+  offset += sizeof(U32);
+  PatternDatabase patternDatabase;
+  for (U32 i = 0; i < regionCount; i++) {
+    Region region;
+    region.upMask = readInteger<U64>(bytes, offset, FormatName);
+    region.blockedMask = readInteger<U64>(bytes, offset + sizeof(U64), FormatName);
+    offset += 2 * sizeof(U64);
+    const auto bitCount = std::popcount(region.upMask) + std::popcount(region.blockedMask);
+    if (bitCount > MaximumRegionBitCount || (region.blockedMask & ~region.upMask) != 0) {
+      throw std::invalid_argument("Pattern database has an invalid region.");
+    }
+    const auto stateCount = std::size_t{1} << static_cast<U32>(bitCount);
+    if (bytes.size() - offset < stateCount) {
+      throw std::invalid_argument("Pattern database is truncated.");
+    }
+    region.clickCounts.assign(std::begin(bytes) + offset, std::begin(bytes) + offset + stateCount);
+    region.prepareGathers();
+    offset += stateCount;
+    patternDatabase.regions.push_back(std::move(region));
+  }
+  return patternDatabase;
+}
+
+std::string PatternDatabase::serialize() const {
+  std::string bytes(Magic);
+  writeInteger<U32>(bytes, Version);
+  writeInteger<U32>(bytes, regions.size());
+  for (const auto &region : regions) {
+    writeInteger<U64>(bytes, region.upMask);
+    writeInteger<U64>(bytes, region.blockedMask);
+    bytes.append(std::begin(region.clickCounts), std::end(region.clickCounts));
+  }
+  return bytes;
+}
+
+std::size_t PatternDatabase::getRegionCount() const {
+  return regions.size();
+}
+
+void PatternDatabase::Region::prepareGathers() {
+  gathers.clear();
+  for (const auto blockedPlane : {false, true}) {
+    const auto mask = blockedPlane ? blockedMask : upMask;
+    const auto offset = blockedPlane ? std::popcount(upMask) : 0;
+    for (U32 shift = 0; shift < 64; shift += 8) {
+      if ((mask >> shift & 0xffu) == 0) {
+        continue;
+      }
+      ByteGather gather;
+      gather.blockedPlane = blockedPlane;
+      gather.shift = shift;
+      for (U64 byte = 0; byte < gather.bits.size(); byte++) {
+        gather.bits[byte] = static_cast<U16>(extractBits(byte << shift, mask) << offset);
+      }
+      gathers.push_back(gather);
+    }
+  }
+}
+
+S32 PatternDatabase::estimateClicks(const PackedBoard &board) const {
+  S32 clicks = 0;
+  for (const auto &region : regions) {
+    // Looking bits up a byte at a time is much faster than gathering them one by one.
+    U32 state = 0;
+    for (const auto &gather : region.gathers) {
+      state |= gather.bits[((gather.blockedPlane ? board.blocked : board.up) >> gather.shift) & 0xffu];
+    }
+    const auto regionClicks = region.clickCounts[state];
+    if (regionClicks == UnsolvableClickCount) {
+      return Unsolvable;
+    }
+    clicks += regionClicks;
+  }
+  return clicks;
+}
+} // namespace WayoutPlayer
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <array>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "BoardLayout.hpp"
+#include "PackedBoard.hpp"
+#include "Types.hpp"
+
+namespace WayoutPlayer {
+/**
+ * Lower bounds on the number of clicks needed to solve a board, looked up from precomputed tables.
+ *
+ * The tiles are partitioned into small regions. For every pattern of raised and blocked tiles of a region, its table
+ * holds the minimum number of clicks on tiles of the region needed to clear it, letting clicks on other tiles affect it
+ * for free. Every click is counted by a single region, so the sum over the regions never overestimates.
+ *
+ * Tables only depend on the layout of the board, so they can be stored on disk and reused for boards with that layout.
+ */
+class PatternDatabase {
+  /**
+   * The bits of the state of a region which come from one byte of a plane of a packed board, for every byte value.
+   */
+  class ByteGather {
+  public:
+    bool blockedPlane = false;
+    U32 shift = 0;
+    std::array<U16, 256> bits{};
+  };
+
+  class Region {
+  public:
+    U64 upMask = 0;
+    U64 blockedMask = 0;
+    std::vector<U8> clickCounts;
+    std::vector<ByteGather> gathers;
+
+    void prepareGathers();
+  };
+
+  std::vector<Region> regions;
+
+  PatternDatabase() = default;
+
+public:
+  static constexpr S32 Unsolvable = -1;
+
+  /**
+   * Returns whether or not tables can be built for boards with the layout.
+   *
+   * Chain and Twin tiles change tiles far away from the one clicked, so boards with them are not supported.
+   */
+  static bool canBeBuilt(const BoardLayout &layout);
+
+  static PatternDatabase build(const BoardLayout &layout);
+
+  /**
+   * Reads the tables for the layout from the directory, or builds them and writes them there.
+   */
+  static PatternDatabase loadOrBuild(const BoardLayout &layout, const std::string &directory);
+
+  static PatternDatabase deserialize(std::string_view bytes);
+
+  [[nodiscard]] std::string serialize() const;
+
+  [[nodiscard]] std::size_t getRegionCount() const;
+
+  /**
+   * Returns a lower bound on the number of clicks needed to solve the board, or Unsolvable if it cannot be solved.
+   */
+  [[nodiscard]] S32 estimateClicks(const PackedBoard &board) const;
+};
+} // namespace WayoutPlayer
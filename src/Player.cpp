@@ -1,30 +1,173 @@
 #include "ArgumentParser.hpp"
 #include "Board.hpp"
+#include "BoardReader.hpp"
+#include "Corpus.hpp"
 #include "Filesystem.hpp"
+#include "Session.hpp"
+#include "SolveServer.hpp"
 #include "Solver.hpp"
 #include "SystemInformation.hpp"
 
+#include <chrono>
 #include <iostream>
+#include <sstream>
+#include <thread>
+
+#include <unistd.h>
 
 using namespace WayoutPlayer;
 
+// Components are remembered across all the boards of a run.
+constexpr std::size_t DefaultComponentCacheSize = 64u << 20u;
+// The seen boards of large searches are probed faster from transparent huge pages.
+const std::string DefaultHugePages = "transparent";
+
+std::size_t getComponentCacheSize(const ArgumentParser &argumentParser) {
+  if (const auto size = argumentParser.getOption("component-cache-size")) {
+    return std::stoull(*size);
+  }
+  return DefaultComponentCacheSize;
+}
+
 void informAboutException(const std::exception &exception) {
   std::cout << "Threw an exception." << '\n';
   std::cout << "  " << exception.what() << '\n';
 }
 
+void solveAndPrint(const Solver &solver, const std::string &name, const Board &board) {
+  if (!name.empty()) {
+    std::cout << "# " << name << '\n';
+  }
+  std::cout << board.toString() << '\n';
+  try {
+    const auto solution = solver.findSolution(board);
+    std::cout << solution.toString() << '\n';
+    std::cout << solution.getStatisticsString() << '\n';
+  } catch (const std::exception &exception) {
+    informAboutException(exception);
+  }
+}
+
+/**
+ * Plays the first board of the input with the clicks read from the standard input, one "i j" pair per line, printing
+ * the board and the clicks which solve what remains of it after every click.
+ */
+void play(const Solver &solver, const std::string &input) {
+  BoardReader boardReader(input);
+  const auto record = boardReader.next();
+  if (!record) {
+    throw std::invalid_argument("The input has no boards.");
+  }
+  Session session(solver, record->board);
+  const auto printState = [&session]() {
+    std::cout << session.getBoard().toString() << '\n';
+    try {
+      std::cout << session.getSolution().toString() << '\n';
+    } catch (const std::exception &exception) {
+      informAboutException(exception);
+    }
+    std::cout << std::flush;
+  };
+  printState();
+  std::string line;
+  while (std::getline(std::cin, line)) {
+    std::istringstream stream(line);
+    S32 i = 0;
+    S32 j = 0;
+    if (!(stream >> i >> j)) {
+      std::cout << "Expected a row and a column." << '\n';
+      continue;
+    }
+    // Positions are narrower than what is read, so anything outside the board would wrap around to another tile.
+    const auto &board = session.getBoard();
+    if (i < 0 || i >= board.getRowCount() || j < 0 || j >= board.getColumnCount()) {
+      std::cout << "Expected a row and a column within the board." << '\n';
+      continue;
+    }
+    try {
+      session.click(Position(static_cast<IndexType>(i), static_cast<IndexType>(j)));
+      printState();
+    } catch (const std::exception &exception) {
+      informAboutException(exception);
+    }
+  }
+}
+
 int main(int argc, char **argv) {
   try {
     ArgumentParser argumentParser;
     argumentParser.parseArguments(argc, argv);
-    const auto boardString = readFile(argumentParser.getArgument(1));
-    const auto board = Board::fromString(boardString);
-    std::cout << board.toString() << '\n';
+    if (argumentParser.getArgument(1) == "--serve") {
+      // Boards are solved concurrently, so each one is solved by a single thread and nothing else is printed.
+      auto solver = Solver();
+      solver.getSolverConfiguration().setComponentCacheSize(getComponentCacheSize(argumentParser));
+      SolveServer server(solver, std::thread::hardware_concurrency());
+      const auto socketPath = argumentParser.getArgument(2);
+      if (socketPath == "-") {
+        server.serve(STDIN_FILENO, STDOUT_FILENO);
+        return 0;
+      }
+      server.listen(socketPath);
+    }
+    // While playing, only the board and the clicks which solve it are printed after every click.
+    const auto playing = argumentParser.getArgument(1) == "--play";
+    const MappedFile inputFile(argumentParser.getArgument(playing ? 2 : 1));
     auto solver = Solver();
-    solver.getSolverConfiguration().setVerbose(true);
-    const auto solution = solver.findSolution(board);
-    std::cout << solution.toString() << '\n';
-    std::cout << solution.getStatisticsString() << '\n';
+    solver.getSolverConfiguration().setVerbose(!playing);
+    solver.getSolverConfiguration().setSampleResources(!playing);
+    solver.getSolverConfiguration().setThreadCount(std::thread::hardware_concurrency());
+    solver.getSolverConfiguration().setComponentCacheSize(getComponentCacheSize(argumentParser));
+    if (const auto engine = argumentParser.getOption("engine")) {
+      solver.getSolverConfiguration().setEngine(solverEngineFromString(*engine));
+    }
+    const auto hugePages = argumentParser.getOption("huge-pages").value_or(DefaultHugePages);
+    solver.getSolverConfiguration().setHugePages(hugePagesFromString(hugePages));
+    if (const auto size = argumentParser.getOption("transposition-table-size")) {
+      solver.getSolverConfiguration().setTranspositionTableSize(std::stoull(*size));
+    }
+    if (const auto budget = argumentParser.getOption("local-search-time-budget")) {
+      solver.getSolverConfiguration().setLocalSearchTimeBudget(std::chrono::milliseconds(std::stoull(*budget)));
+    }
+    if (const auto width = argumentParser.getOption("beam-width")) {
+      solver.getSolverConfiguration().setBeamWidth(static_cast<U32>(std::stoul(*width)));
+    }
+    if (const auto budget = argumentParser.getOption("beam-search-time-budget")) {
+      solver.getSolverConfiguration().setBeamSearchTimeBudget(std::chrono::milliseconds(std::stoull(*budget)));
+    }
+    if (const auto directory = argumentParser.getOption("pattern-database-directory")) {
+      solver.getSolverConfiguration().setPatternDatabaseDirectory(*directory);
+    }
+    if (const auto directory = argumentParser.getOption("endgame-table-directory")) {
+      solver.getSolverConfiguration().setEndgameTableDirectory(*directory);
+    }
+    if (playing) {
+      play(solver, std::string(inputFile.getContents()));
+    } else if (Corpus::isCorpus(inputFile.getContents())) {
+      // A corpus is solved entirely, or only for the board with the digest given as the second argument.
+      const Corpus corpus(inputFile.getContents());
+      if (argumentParser.getArgumentCount() > 2) {
+        const auto entry = corpus.find(digestFromHexadecimal(argumentParser.getArgument(2)));
+        if (!entry) {
+          throw std::invalid_argument("The corpus has no board with this digest.");
+        }
+        solveAndPrint(solver, digestToHexadecimal(entry->digest), entry->board);
+      } else {
+        for (U32 index = 0; index < corpus.getEntryCount(); index++) {
+          const auto entry = corpus.getEntry(index);
+          solveAndPrint(solver, digestToHexadecimal(entry.digest), entry.board);
+        }
+      }
+    } else {
+      BoardReader boardReader(inputFile.getContents());
+      auto readAnyBoard = false;
+      while (const auto record = boardReader.next()) {
+        readAnyBoard = true;
+        solveAndPrint(solver, record->name, record->board);
+      }
+      if (!readAnyBoard) {
+        throw std::invalid_argument("The input has no boards.");
+      }
+    }
   } catch (const std::exception &exception) {
     informAboutException(exception);
   }
@@ -0,0 +1,106 @@
+#include "RevolvingDoor.hpp"
+
+#include <limits>
+#include <stdexcept>
+
+namespace WayoutPlayer {
+U64 binomialCoefficient(S32 n, S32 k) {
+  if (k < 0 || k > n) {
+    return 0;
+  }
+  k = std::min(k, n - k);
+  unsigned __int128 result = 1;
+  for (S32 i = 1; i <= k; i++) {
+    // After this step, result is the binomial coefficient of (n - k + i, i), so the division is exact.
+    result = result * static_cast<U64>(n - k + i) / static_cast<U64>(i);
+    if (result > std::numeric_limits<U64>::max()) {
+      throw std::overflow_error("Binomial coefficient does not fit in 64 bits.");
+    }
+  }
+  return static_cast<U64>(result);
+}
+
+RevolvingDoorCombination::RevolvingDoorCombination(S32 newN, S32 newT, U64 rank) : n(newN), t(newT), elements(newT + 1) {
+  if (t < 0 || t > n) {
+    throw std::invalid_argument("Invalid combination size.");
+  }
+  if (rank >= binomialCoefficient(n, t)) {
+    throw std::invalid_argument("Combination rank is out of range.");
+  }
+  elements[t] = n;
+  // The revolving-door sequence for (m, s) is the sequence for (m - 1, s) followed by the reversed sequence for
+  // (m - 1, s - 1) with m - 1 added to every combination.
+  auto m = n;
+  auto s = t;
+  while (s > 0) {
+    if (s == m) {
+      for (S32 k = 0; k < s; k++) {
+        elements[k] = k;
+      }
+      break;
+    }
+    const auto withoutLast = binomialCoefficient(m - 1, s);
+    if (rank < withoutLast) {
+      m--;
+    } else {
+      rank = binomialCoefficient(m - 1, s - 1) - 1 - (rank - withoutLast);
+      elements[s - 1] = m - 1;
+      m--;
+      s--;
+    }
+  }
+}
+
+std::vector<S32> RevolvingDoorCombination::getElements() const {
+  return std::vector<S32>(std::begin(elements), std::begin(elements) + t);
+}
+
+bool RevolvingDoorCombination::next(S32 &removed, S32 &added) {
+  // This is Algorithm R from Knuth's TAOCP, Volume 4A, Section 7.2.1.3, with zero-based element storage.
+  // c_j from the book is elements[j - 1].
+  if (t == 0 || t == n) {
+    return false;
+  }
+  auto &c = elements;
+  S32 j = 2;
+  auto tryingToIncrease = false;
+  if (t % 2 == 1) {
+    if (c[0] + 1 < c[1]) {
+      removed = c[0];
+      c[0]++;
+      added = c[0];
+      return true;
+    }
+  } else {
+    if (c[0] > 0) {
+      removed = c[0];
+      c[0]--;
+      added = c[0];
+      return true;
+    }
+    tryingToIncrease = true;
+  }
+  while (j <= t) {
+    if (tryingToIncrease) {
+      if (c[j - 1] + 1 < c[j]) {
+        removed = c[j - 2];
+        added = c[j - 1] + 1;
+        c[j - 2] = c[j - 1];
+        c[j - 1]++;
+        return true;
+      }
+    } else {
+      if (c[j - 1] >= j) {
+        removed = c[j - 1];
+        added = j - 2;
+        c[j - 1] = c[j - 2];
+        c[j - 2] = j - 2;
+        return true;
+      }
+    }
+    tryingToIncrease = !tryingToIncrease;
+    j++;
+  }
+  return false;
+}
+} // namespace WayoutPlayer
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <vector>
+
+#include "Types.hpp"
+
+namespace WayoutPlayer {
+/**
+ * Returns the number of ways to choose k elements out of n.
+ *
+ * Throws if the result does not fit in 64 bits.
+ */
+U64 binomialCoefficient(S32 n, S32 k);
+
+/**
+ * A t-combination of {0, 1, ..., n - 1} which steps through the revolving-door Gray code.
+ *
+ * Consecutive combinations differ by exactly one element leaving and one element entering the combination. The
+ * combinations are ranked in the order in which they are visited, so that the sequence can be split into ranges.
+ */
+class RevolvingDoorCombination {
+  S32 n;
+  S32 t;
+  // The elements in ascending order, followed by n as a sentinel.
+  std::vector<S32> elements;
+
+public:
+  RevolvingDoorCombination(S32 newN, S32 newT, U64 rank = 0);
+
+  /**
+   * Returns the elements of the combination in ascending order.
+   */
+  [[nodiscard]] std::vector<S32> getElements() const;
+
+  /**
+   * Advances to the next combination and writes which element left and which element entered it.
+   *
+   * Returns false, leaving the combination unchanged, if this is the last combination.
+   */
+  bool next(S32 &removed, S32 &added);
+};
+} // namespace WayoutPlayer
@@ -0,0 +1,90 @@
+#include "Session.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace WayoutPlayer {
+Session::Session(const Solver &newSolver, const Board &initialBoard) : solver(newSolver), board(initialBoard) {
+  const auto rowCount = board.getRowCount();
+  const auto columnCount = board.getColumnCount();
+  componentIndices.assign(static_cast<std::size_t>(rowCount * columnCount), -1);
+  for (const auto &componentBoard : board.splitComponents()) {
+    const auto componentIndex = static_cast<S32>(components.size());
+    for (S32 i = 0; i < rowCount; i++) {
+      for (S32 j = 0; j < columnCount; j++) {
+        if (componentBoard.hasTile(i, j)) {
+          componentIndices[i * columnCount + j] = componentIndex;
+        }
+      }
+    }
+    components.push_back({componentBoard, std::nullopt, ""});
+  }
+  for (auto &component : components) {
+    solveComponent(component);
+  }
+}
+
+void Session::solveComponent(ComponentState &component) {
+  solveCount++;
+  try {
+    component.solution = solver.findSolution(component.board);
+    component.error.clear();
+  } catch (const std::exception &exception) {
+    component.solution.reset();
+    component.error = exception.what();
+  }
+}
+
+const Board &Session::getBoard() const {
+  return board;
+}
+
+Solution Session::getSolution() const {
+  std::vector<Position> clicks;
+  auto optimal = true;
+  for (const auto &component : components) {
+    if (!component.solution) {
+      throw std::runtime_error(component.error);
+    }
+    const auto &componentClicks = component.solution->getClicks();
+    clicks.insert(std::end(clicks), std::begin(componentClicks), std::end(componentClicks));
+    optimal = optimal && component.solution->isOptimal();
+  }
+  return Solution(clicks, optimal);
+}
+
+U64 Session::getClickCount() const {
+  return clickCount;
+}
+
+U64 Session::getSolveCount() const {
+  return solveCount;
+}
+
+void Session::click(Position position) {
+  if (!board.hasTile(position.i, position.j)) {
+    throw std::invalid_argument("There is no tile at " + position.toString() + ".");
+  }
+  if (board.getTile(position.i, position.j).type == TileType::Blocked) {
+    throw std::invalid_argument("Cannot click the blocked tile at " + position.toString() + ".");
+  }
+  auto &component = components[componentIndices[position.i * board.getColumnCount() + position.j]];
+  const auto clicksCommuted = component.board.hasCommutativeClicks();
+  board.activate(position.i, position.j);
+  component.board.activate(position.i, position.j);
+  clickCount++;
+  if (component.solution) {
+    // What remains of a solution after its first click solves the board that click leaves, and no shorter sequence
+    // does, as it would give a shorter solution before the click. Clicks which commute can be made in any order.
+    auto clicks = component.solution->getClicks();
+    auto click = std::find(std::begin(clicks), std::end(clicks), position);
+    const auto canBeRemoved = click == std::begin(clicks) || (clicksCommuted && component.board.hasCommutativeClicks());
+    if (click != std::end(clicks) && canBeRemoved) {
+      clicks.erase(click);
+      component.solution = Solution(clicks, component.solution->isOptimal());
+      return;
+    }
+  }
+  solveComponent(component);
+}
+} // namespace WayoutPlayer
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "Board.hpp"
+#include "Position.hpp"
+#include "Solution.hpp"
+#include "Solver.hpp"
+#include "Types.hpp"
+
+namespace WayoutPlayer {
+/**
+ * A board being played, which keeps a solution of what remains of it up to date after every click.
+ *
+ * Every component keeps its own solution, so a click only affects the component it lands on. Clicking the next click
+ * of the solution of a component leaves the rest of it, which is still optimal, and so does clicking any click of the
+ * solution while the clicks of the component commute. Only other clicks solve the component again, with the solver of
+ * the session, whose component cache and endgame tables are kept between clicks. Pattern databases are not kept, as
+ * iterative deepening builds or loads them on every solve.
+ */
+class Session {
+  class ComponentState {
+  public:
+    Board board;
+    std::optional<Solution> solution;
+    // Why the component has no solution, when it has none.
+    std::string error;
+  };
+
+  const Solver &solver;
+  Board board;
+  std::vector<ComponentState> components;
+  // The index of the component of every tile in row-major order, or -1 where there is no tile.
+  std::vector<S32> componentIndices;
+  U64 clickCount = 0;
+  U64 solveCount = 0;
+
+  void solveComponent(ComponentState &component);
+
+public:
+  /**
+   * Starts playing the board, solving all of it. The solver must outlive the session.
+   */
+  Session(const Solver &newSolver, const Board &initialBoard);
+
+  [[nodiscard]] const Board &getBoard() const;
+
+  /**
+   * Returns the clicks which solve what remains of the board, or throws the reason why it cannot be solved anymore.
+   */
+  [[nodiscard]] Solution getSolution() const;
+
+  /**
+   * Returns the number of clicks made since the session started.
+   */
+  [[nodiscard]] U64 getClickCount() const;
+
+  /**
+   * Returns the number of times a component was given to the solver, including when the session started.
+   */
+  [[nodiscard]] U64 getSolveCount() const;
+
+  void click(Position position);
+};
+} // namespace WayoutPlayer
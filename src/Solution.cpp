@@ -1,6 +1,8 @@
 #include "Solution.hpp"
 #include "Text.hpp"
 
+#include <algorithm>
+#include <cstdio>
 #include <iomanip>
 #include <sstream>
 #include <utility>
@@ -49,6 +51,69 @@ std::optional<F64> Solution::getMeanBranchingFactor() const {
   return std::nullopt;
 }
 
+std::optional<U64> Solution::getArenaReservedBytes() const {
+  return arenaReservedBytes;
+}
+
+void Solution::setArenaReservedBytes(const U64 newArenaReservedBytes) {
+  arenaReservedBytes = newArenaReservedBytes;
+}
+
+std::optional<U64> Solution::getArenaUsedBytes() const {
+  return arenaUsedBytes;
+}
+
+void Solution::setArenaUsedBytes(const U64 newArenaUsedBytes) {
+  arenaUsedBytes = newArenaUsedBytes;
+}
+
+std::string MemoryBreakdown::toString() const {
+  std::vector<std::string> parts;
+  const auto addPart = [&parts](const std::optional<U64> &value, const std::string &suffix) {
+    if (value) {
+      parts.push_back(integerToStringWithThousandSeparators(*value) + suffix);
+    }
+  };
+  addPart(frontierBytes, " B in the frontier");
+  addPart(seenBoardBytes, " B in seen boards");
+  addPart(pathBytes, " B in paths");
+  addPart(residentSetSizeBytes, " B resident");
+  addPart(minorPageFaults, " minor page faults");
+  addPart(majorPageFaults, " major page faults");
+  std::string string;
+  for (const auto &part : parts) {
+    string += string.empty() ? part : ", " + part;
+  }
+  return string;
+}
+
+HardwareCounts &HardwareCounts::operator+=(const HardwareCounts &rhs) {
+  instructions += rhs.instructions;
+  cycles += rhs.cycles;
+  cacheMisses += rhs.cacheMisses;
+  branchMisses += rhs.branchMisses;
+  return *this;
+}
+
+const std::optional<HardwareCounts> &Solution::getHardwareCounts() const {
+  return hardwareCounts;
+}
+
+void Solution::setHardwareCounts(const HardwareCounts &newHardwareCounts) {
+  hardwareCounts = newHardwareCounts;
+}
+
+const std::vector<MemoryBreakdown> &Solution::getMemoryBreakdowns() const {
+  return memoryBreakdowns;
+}
+
+MemoryBreakdown &Solution::getMemoryBreakdown() {
+  if (memoryBreakdowns.empty()) {
+    memoryBreakdowns.emplace_back();
+  }
+  return memoryBreakdowns.back();
+}
+
 std::string Solution::toString() const {
   std::string string;
   if (isOptimal()) {
@@ -69,6 +134,44 @@ std::string Solution::toString() const {
   return string;
 }
 
+Solution Solution::fromString(std::string_view string) {
+  const std::string OptimalPrefix = "Found an optimal solution with ";
+  const std::string NonOptimalPrefix = "Found a solution with ";
+  std::optional<bool> isOptimal;
+  std::size_t clickCount = 0;
+  while (!string.empty() && !isOptimal) {
+    const auto lineEnd = string.find('\n');
+    const auto line = string.substr(0, lineEnd);
+    string.remove_prefix(lineEnd == std::string_view::npos ? string.size() : lineEnd + 1);
+    if (line.starts_with(OptimalPrefix)) {
+      isOptimal = true;
+      clickCount = std::stoull(std::string(line.substr(OptimalPrefix.size())));
+    } else if (line.starts_with(NonOptimalPrefix)) {
+      isOptimal = false;
+      clickCount = std::stoull(std::string(line.substr(NonOptimalPrefix.size())));
+    }
+  }
+  if (!isOptimal) {
+    throw std::invalid_argument("Could not find a solution in the string.");
+  }
+  std::vector<Position> clickVector;
+  std::istringstream stream{std::string(string)};
+  std::string line;
+  while (clickVector.size() < clickCount && std::getline(stream, line)) {
+    long long i = 0;
+    long long j = 0;
+    char unused = 0;
+    if (std::sscanf(line.c_str(), " (%lld, %lld%c", &i, &j, &unused) != 3 || unused != ')') {
+      break;
+    }
+    clickVector.emplace_back(static_cast<IndexType>(i), static_cast<IndexType>(j));
+  }
+  if (clickVector.size() != clickCount) {
+    throw std::invalid_argument("Expected " + toPluralizedString(clickCount, "click") + " in the solution.");
+  }
+  return Solution(clickVector, *isOptimal);
+}
+
 std::string Solution::getStatisticsString() const {
   std::string string;
   if (getExploredNodes()) {
@@ -88,6 +191,41 @@ std::string Solution::getStatisticsString() const {
     stream << std::fixed << std::setprecision(2) << getMeanBranchingFactor().value();
     string += "Mean branching factor: " + stream.str();
   }
+  if (getHardwareCounts() && getExploredNodes().value_or(0) > 0) {
+    if (!string.empty()) {
+      string += '\n';
+    }
+    const auto exploredNodeCount = static_cast<F64>(getExploredNodes().value());
+    std::stringstream stream;
+    stream << std::fixed << std::setprecision(2);
+    stream << "Per explored node: " << static_cast<F64>(hardwareCounts->instructions) / exploredNodeCount;
+    stream << " instructions, " << static_cast<F64>(hardwareCounts->cycles) / exploredNodeCount;
+    stream << " cycles, " << static_cast<F64>(hardwareCounts->cacheMisses) / exploredNodeCount;
+    stream << " cache misses, " << static_cast<F64>(hardwareCounts->branchMisses) / exploredNodeCount;
+    stream << " branch misses";
+    string += stream.str();
+  }
+  if (getArenaUsedBytes() && getArenaReservedBytes()) {
+    if (!string.empty()) {
+      string += '\n';
+    }
+    string += "Arena memory: " + integerToStringWithThousandSeparators(getArenaUsedBytes().value()) + " B used of ";
+    string += integerToStringWithThousandSeparators(getArenaReservedBytes().value()) + " B reserved";
+  }
+  for (std::size_t index = 0; index < memoryBreakdowns.size(); index++) {
+    const auto breakdown = memoryBreakdowns[index].toString();
+    if (breakdown.empty()) {
+      continue;
+    }
+    if (!string.empty()) {
+      string += '\n';
+    }
+    if (memoryBreakdowns.size() == 1) {
+      string += "Peak memory: " + breakdown;
+    } else {
+      string += "Peak memory of component " + std::to_string(index + 1) + ": " + breakdown;
+    }
+  }
   return string;
 }
 
@@ -106,5 +244,30 @@ void Solution::add(const Solution &other) {
   } else {
     distinctNodes = std::nullopt;
   }
+
+  // Components without counts, such as those which were not searched, add nothing.
+  if (other.hardwareCounts) {
+    if (!hardwareCounts) {
+      hardwareCounts.emplace();
+    }
+    *hardwareCounts += *other.hardwareCounts;
+  }
+
+  // Components are solved one after the other and each arena is released before the next one is created.
+  if (other.arenaReservedBytes) {
+    setArenaReservedBytes(std::max(getArenaReservedBytes().value_or(0), *other.getArenaReservedBytes()));
+  }
+  if (other.arenaUsedBytes) {
+    setArenaUsedBytes(std::max(getArenaUsedBytes().value_or(0), *other.getArenaUsedBytes()));
+  }
+  // Solutions without breakdowns still count as components, so that the numbers match the order of solving.
+  if (memoryBreakdowns.empty()) {
+    memoryBreakdowns.emplace_back();
+  }
+  if (other.memoryBreakdowns.empty()) {
+    memoryBreakdowns.emplace_back();
+  }
+  memoryBreakdowns.insert(std::end(memoryBreakdowns), std::begin(other.memoryBreakdowns),
+                          std::end(other.memoryBreakdowns));
 }
 } // namespace WayoutPlayer
\ No newline at end of file
@@ -3,9 +3,42 @@
 #include "Position.hpp"
 
 #include <optional>
+#include <string>
+#include <string_view>
 #include <vector>
 
 namespace WayoutPlayer {
+/**
+ * The most memory held by each structure of a search, and by the process, while a single component was solved.
+ *
+ * Structures the engine does not have are left empty.
+ */
+class MemoryBreakdown {
+public:
+  std::optional<U64> frontierBytes;
+  std::optional<U64> seenBoardBytes;
+  std::optional<U64> pathBytes;
+
+  std::optional<U64> residentSetSizeBytes;
+  std::optional<U64> minorPageFaults;
+  std::optional<U64> majorPageFaults;
+
+  [[nodiscard]] std::string toString() const;
+};
+
+/**
+ * Hardware events counted by the processor while the components of a solution were solved.
+ */
+class HardwareCounts {
+public:
+  U64 instructions = 0;
+  U64 cycles = 0;
+  U64 cacheMisses = 0;
+  U64 branchMisses = 0;
+
+  HardwareCounts &operator+=(const HardwareCounts &rhs);
+};
+
 class Solution {
   std::vector<Position> clicks;
   bool optimal;
@@ -13,6 +46,14 @@ class Solution {
   std::optional<U64> exploredNodes;
   std::optional<U64> distinctNodes;
 
+  std::optional<U64> arenaReservedBytes;
+  std::optional<U64> arenaUsedBytes;
+
+  // One for every component, in the order in which they were solved.
+  std::vector<MemoryBreakdown> memoryBreakdowns;
+
+  std::optional<HardwareCounts> hardwareCounts;
+
 public:
   Solution(std::vector<Position> clickVector, bool isOptimal);
 
@@ -32,8 +73,40 @@ public:
 
   [[nodiscard]] std::optional<F64> getMeanBranchingFactor() const;
 
+  /**
+   * Returns the largest number of bytes an arena took from the system while solving a component.
+   */
+  [[nodiscard]] std::optional<U64> getArenaReservedBytes() const;
+  void setArenaReservedBytes(U64 newArenaReservedBytes);
+
+  /**
+   * Returns the largest number of bytes allocated from an arena at the same time while solving a component.
+   */
+  [[nodiscard]] std::optional<U64> getArenaUsedBytes() const;
+  void setArenaUsedBytes(U64 newArenaUsedBytes);
+
+  /**
+   * Returns the hardware events counted while solving, if the processor and the kernel allowed counting them.
+   */
+  [[nodiscard]] const std::optional<HardwareCounts> &getHardwareCounts() const;
+  void setHardwareCounts(const HardwareCounts &newHardwareCounts);
+
+  [[nodiscard]] const std::vector<MemoryBreakdown> &getMemoryBreakdowns() const;
+
+  /**
+   * Returns the breakdown of the last component solved, which is created if there is none.
+   */
+  [[nodiscard]] MemoryBreakdown &getMemoryBreakdown();
+
   [[nodiscard]] std::string toString() const;
 
+  /**
+   * Reads a solution written by toString, which may be surrounded by other lines of text.
+   *
+   * Statistics are not read.
+   */
+  static Solution fromString(std::string_view string);
+
   [[nodiscard]] std::string getStatisticsString() const;
 
   void add(const Solution &other);
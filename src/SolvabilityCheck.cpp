@@ -0,0 +1,82 @@
+#include "SolvabilityCheck.hpp"
+
+#include <bit>
+#include <vector>
+
+#include "Bits.hpp"
+#include "BoardLayout.hpp"
+#include "LinearSystem.hpp"
+#include "PackedBoard.hpp"
+
+namespace WayoutPlayer {
+namespace {
+std::string listPositions(const BoardLayout &layout, U64 mask) {
+  std::string list;
+  for (auto remaining = mask; remaining != 0; remaining &= remaining - 1) {
+    if (!list.empty()) {
+      list += (remaining & (remaining - 1)) == 0 ? " and " : ", ";
+    }
+    list += layout.getPosition(std::countr_zero(remaining)).toString();
+  }
+  return list;
+}
+} // namespace
+
+std::optional<std::string> findUnsolvabilityReason(const Board &component) {
+  const BoardLayout layout(component);
+  if (!layout.canBePacked()) {
+    return std::nullopt;
+  }
+  const auto tileCount = layout.getTileCount();
+  const auto upMask = layout.getUpMask(component);
+  const auto blockedMask = layout.getBlockedMask(component);
+  const auto clickReaches = layout.computeClickReaches();
+  for (auto blocked = blockedMask; blocked != 0; blocked &= blocked - 1) {
+    const auto blockedIndex = std::countr_zero(blocked);
+    auto reached = false;
+    for (S32 index = 0; index < tileCount && !reached; index++) {
+      reached = index != blockedIndex && (clickReaches[index] & bitOf(blockedIndex)) != 0;
+    }
+    if (!reached) {
+      const auto position = layout.getPosition(blockedIndex).toString();
+      return "Cannot be solved, as no click reaches the blocked tile at " + position + ".";
+    }
+  }
+  const auto twinMask = layout.getTwinMask();
+  const auto raisedTwins = upMask & twinMask;
+  const auto twinsInStep = raisedTwins == 0 || raisedTwins == twinMask;
+  const auto linearMask = ~blockedMask & (twinsInStep ? ~U64{0} : ~twinMask);
+  // The effects of the clicks on the linear tiles are read from clicking every tile of an unblocked board once.
+  std::vector<U64> effects;
+  for (S32 index = 0; index < tileCount; index++) {
+    PackedBoard board;
+    board.activate(layout, index);
+    effects.push_back(board.up & linearMask);
+  }
+  // A set of linear tiles every click flips an even number of is a solution of the transposed system.
+  std::vector<S32> linearIndices;
+  std::vector<U64> clicksFlipping;
+  for (S32 tile = 0; tile < tileCount; tile++) {
+    if ((linearMask & bitOf(tile)) != 0) {
+      U64 clicks = 0;
+      for (S32 index = 0; index < tileCount; index++) {
+        clicks |= (effects[index] & bitOf(tile)) != 0 ? bitOf(index) : 0;
+      }
+      linearIndices.push_back(tile);
+      clicksFlipping.push_back(clicks);
+    }
+  }
+  const LinearSystem transposedSystem(clicksFlipping);
+  for (const auto combination : transposedSystem.getNullSpaceBasis()) {
+    U64 tiles = 0;
+    for (auto remaining = combination; remaining != 0; remaining &= remaining - 1) {
+      tiles |= bitOf(linearIndices[std::countr_zero(remaining)]);
+    }
+    if (std::popcount(tiles & upMask) % 2 == 1) {
+      return "Cannot be solved, as every click flips an even number of the tiles at " + listPositions(layout, tiles) +
+             ", of which an odd number are raised.";
+    }
+  }
+  return std::nullopt;
+}
+} // namespace WayoutPlayer
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <optional>
+#include <string>
+
+#include "Board.hpp"
+
+namespace WayoutPlayer {
+/**
+ * Returns why the component cannot be solved, or nothing if that could not be proven.
+ *
+ * Blocked tiles which no other tile reaches can never be unblocked. Besides, the only tiles whose changes depend on
+ * the state of the board are the blocked tiles and the twins out of step, so every click flips the same set of the
+ * other tiles whenever it is made. If the raised tiles among them are not a sum of these sets over GF(2), some set of
+ * tiles is flipped an even number of times by every click but has an odd number of raised tiles, so the component
+ * cannot be solved. Clicks which are impossible on the board are also counted, which only makes the proof harder.
+ *
+ * Components with more tiles than a packed board holds are not checked.
+ */
+std::optional<std::string> findUnsolvabilityReason(const Board &component);
+} // namespace WayoutPlayer
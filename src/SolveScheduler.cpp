@@ -0,0 +1,61 @@
+#include "SolveScheduler.hpp"
+
+#include <algorithm>
+#include <exception>
+#include <stdexcept>
+#include <utility>
+
+namespace WayoutPlayer {
+SolveScheduler::SolveScheduler(const Solver &newSolver) : solver(newSolver) {
+}
+
+U64 SolveScheduler::add(const Board &board, Clock::time_point deadline) {
+  const auto id = nextId++;
+  solves.push_back({id, deadline, solver.solve(board)});
+  return id;
+}
+
+void SolveScheduler::cancel(U64 id) {
+  std::erase_if(solves, [id](const ScheduledSolve &scheduledSolve) { return scheduledSolve.id == id; });
+}
+
+bool SolveScheduler::isEmpty() const {
+  return solves.empty();
+}
+
+std::size_t SolveScheduler::getSize() const {
+  return solves.size();
+}
+
+const SolveProgress &SolveScheduler::getProgress(U64 id) const {
+  const auto isScheduled = [id](const ScheduledSolve &scheduledSolve) { return scheduledSolve.id == id; };
+  const auto iterator = std::find_if(std::begin(solves), std::end(solves), isScheduled);
+  if (iterator == std::end(solves)) {
+    throw std::invalid_argument("There is no scheduled solve " + std::to_string(id) + ".");
+  }
+  return iterator->task.getProgress();
+}
+
+std::optional<SolveOutcome> SolveScheduler::step() {
+  if (solves.empty()) {
+    return std::nullopt;
+  }
+  const auto isMoreUrgent = [](const ScheduledSolve &a, const ScheduledSolve &b) { return a.deadline < b.deadline; };
+  const auto mostUrgent = std::min_element(std::begin(solves), std::end(solves), isMoreUrgent);
+  SolveOutcome outcome;
+  outcome.id = mostUrgent->id;
+  if (Clock::now() >= mostUrgent->deadline) {
+    outcome.error = "The deadline passed.";
+  } else if (mostUrgent->task.resume()) {
+    return std::nullopt;
+  } else {
+    try {
+      outcome.solution = mostUrgent->task.getSolution();
+    } catch (const std::exception &exception) {
+      outcome.error = exception.what();
+    }
+  }
+  solves.erase(mostUrgent);
+  return outcome;
+}
+} // namespace WayoutPlayer
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <chrono>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "Board.hpp"
+#include "Solution.hpp"
+#include "SolveTask.hpp"
+#include "Solver.hpp"
+#include "Types.hpp"
+
+namespace WayoutPlayer {
+/**
+ * How a scheduled solve ended: with a solution, or with the reason it has none.
+ */
+class SolveOutcome {
+public:
+  U64 id = 0;
+  std::optional<Solution> solution;
+  std::string error;
+};
+
+/**
+ * Interleaves many solves on the calling thread, always resuming the solve with the earliest deadline and cancelling
+ * the solves whose deadlines have passed.
+ */
+class SolveScheduler {
+public:
+  using Clock = std::chrono::steady_clock;
+
+private:
+  class ScheduledSolve {
+  public:
+    U64 id;
+    Clock::time_point deadline;
+    SolveTask task;
+  };
+
+  const Solver &solver;
+  std::vector<ScheduledSolve> solves;
+  U64 nextId = 0;
+
+public:
+  explicit SolveScheduler(const Solver &newSolver);
+
+  /**
+   * Schedules a solve of the board and returns its identifier.
+   */
+  U64 add(const Board &board, Clock::time_point deadline);
+
+  /**
+   * Drops the solve with the identifier, if it is still scheduled.
+   */
+  void cancel(U64 id);
+
+  [[nodiscard]] bool isEmpty() const;
+
+  [[nodiscard]] std::size_t getSize() const;
+
+  /**
+   * Returns the progress last reported by the solve with the identifier.
+   */
+  [[nodiscard]] const SolveProgress &getProgress(U64 id) const;
+
+  /**
+   * Resumes the most urgent solve once, and returns the outcome of a solve if one has ended.
+   */
+  std::optional<SolveOutcome> step();
+};
+} // namespace WayoutPlayer
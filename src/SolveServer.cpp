@@ -0,0 +1,202 @@
+#include "SolveServer.hpp"
+
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <future>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <stdexcept>
+#include <thread>
+
+#include <csignal>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "Board.hpp"
+
+namespace WayoutPlayer {
+namespace {
+constexpr std::size_t ReadBufferSize = 64u * 1024u;
+constexpr int ListenBacklog = 64;
+constexpr std::chrono::milliseconds AcceptBackoff(100);
+
+void writeAll(int descriptor, std::string_view data) {
+  while (!data.empty()) {
+    const auto written = write(descriptor, data.data(), data.size());
+    if (written < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      throw std::runtime_error("Failed to write a response: " + std::string(std::strerror(errno)) + ".");
+    }
+    data.remove_prefix(static_cast<std::size_t>(written));
+  }
+}
+} // namespace
+
+SolveServer::SolveServer(const Solver &newSolver, U32 threadCount) : solver(newSolver), threadPool(threadCount) {
+}
+
+std::string SolveServer::respond(std::string_view request) const {
+  std::string response;
+  if (request.starts_with('#')) {
+    const auto headerEnd = request.find('\n');
+    response += request.substr(0, headerEnd);
+    response += '\n';
+    request.remove_prefix(headerEnd == std::string_view::npos ? request.size() : headerEnd + 1);
+  }
+  try {
+    const auto solution = solver.findSolution(Board::fromString(request));
+    response += solution.toString() + '\n';
+    const auto statistics = solution.getStatisticsString();
+    if (!statistics.empty()) {
+      response += statistics + '\n';
+    }
+  } catch (const std::exception &exception) {
+    response += "Threw an exception.\n  " + std::string(exception.what()) + '\n';
+  }
+  return response + '\n';
+}
+
+void SolveServer::serve(int inputDescriptor, int outputDescriptor) {
+  std::mutex mutex;
+  std::condition_variable responseAvailable;
+  std::queue<std::future<std::string>> responses;
+  auto readingFinished = false;
+  // Requests are solved concurrently, but a single writer sends their responses in order.
+  std::thread writer([&] {
+    auto canWrite = true;
+    while (true) {
+      std::future<std::string> response;
+      {
+        std::unique_lock<std::mutex> lock(mutex);
+        responseAvailable.wait(lock, [&] { return readingFinished || !responses.empty(); });
+        if (responses.empty()) {
+          return;
+        }
+        response = std::move(responses.front());
+        responses.pop();
+      }
+      // Even if the client stopped reading, every response is waited for, as it refers to this connection.
+      const auto text = response.get();
+      if (canWrite) {
+        try {
+          writeAll(outputDescriptor, text);
+        } catch (const std::runtime_error &) {
+          canWrite = false;
+        }
+      }
+    }
+  });
+  const auto submit = [&](std::string request) {
+    auto promise = std::make_shared<std::promise<std::string>>();
+    {
+      const std::lock_guard<std::mutex> lock(mutex);
+      responses.push(promise->get_future());
+    }
+    responseAvailable.notify_one();
+    threadPool.submit([this, promise, request = std::move(request)] {
+      try {
+        promise->set_value(respond(request));
+      } catch (const std::exception &exception) {
+        promise->set_value("Threw an exception.\n  " + std::string(exception.what()) + "\n\n");
+      }
+    });
+  };
+  std::string request;
+  std::string pending;
+  std::string buffer(ReadBufferSize, '\0');
+  while (true) {
+    const auto bytesRead = read(inputDescriptor, buffer.data(), buffer.size());
+    if (bytesRead < 0 && errno == EINTR) {
+      continue;
+    }
+    if (bytesRead <= 0) {
+      break;
+    }
+    pending.append(buffer.data(), static_cast<std::size_t>(bytesRead));
+    std::size_t lineBegin = 0;
+    for (auto lineEnd = pending.find('\n'); lineEnd != std::string::npos; lineEnd = pending.find('\n', lineBegin)) {
+      auto line = std::string_view(pending).substr(lineBegin, lineEnd - lineBegin);
+      lineBegin = lineEnd + 1;
+      if (line.ends_with('\r')) {
+        line.remove_suffix(1);
+      }
+      if (line.empty()) {
+        if (!request.empty()) {
+          submit(std::move(request));
+          request.clear();
+        }
+      } else {
+        request.append(line);
+        request += '\n';
+      }
+    }
+    pending.erase(0, lineBegin);
+  }
+  request += pending;
+  if (!request.empty()) {
+    submit(std::move(request));
+  }
+  {
+    const std::lock_guard<std::mutex> lock(mutex);
+    readingFinished = true;
+  }
+  responseAvailable.notify_one();
+  writer.join();
+}
+
+void SolveServer::listen(const std::string &socketPath) {
+  sockaddr_un address{};
+  if (socketPath.size() >= sizeof(address.sun_path)) {
+    throw std::invalid_argument("The socket path is too long.");
+  }
+  // Clients which disconnect early should not terminate the server.
+  std::signal(SIGPIPE, SIG_IGN);
+  const auto listeningDescriptor = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+  if (listeningDescriptor < 0) {
+    throw std::runtime_error("Failed to create a socket.");
+  }
+  address.sun_family = AF_UNIX;
+  std::strncpy(address.sun_path, socketPath.c_str(), sizeof(address.sun_path) - 1);
+  unlink(socketPath.c_str());
+  if (bind(listeningDescriptor, reinterpret_cast<const sockaddr *>(&address), sizeof(address)) != 0) {
+    close(listeningDescriptor);
+    throw std::runtime_error("Failed to bind the socket to " + socketPath + ".");
+  }
+  if (::listen(listeningDescriptor, ListenBacklog) != 0) {
+    close(listeningDescriptor);
+    throw std::runtime_error("Failed to listen on " + socketPath + ".");
+  }
+  while (true) {
+    const auto connectionDescriptor = accept4(listeningDescriptor, nullptr, nullptr, SOCK_CLOEXEC);
+    if (connectionDescriptor < 0) {
+      if (errno == EINTR || errno == ECONNABORTED) {
+        continue;
+      }
+      // Running out of descriptors or memory is temporary, as serving connections close their descriptors.
+      if (errno == EMFILE || errno == ENFILE || errno == ENOBUFS || errno == ENOMEM) {
+        std::this_thread::sleep_for(AcceptBackoff);
+        continue;
+      }
+      const auto error = errno;
+      close(listeningDescriptor);
+      throw std::runtime_error("Failed to accept a connection: " + std::string(std::strerror(error)) + ".");
+    }
+    std::thread([this, connectionDescriptor] {
+      try {
+        serve(connectionDescriptor, connectionDescriptor);
+      } catch (const std::exception &exception) {
+        std::cout << "Threw an exception." << '\n';
+        std::cout << "  " << exception.what() << '\n';
+      }
+      close(connectionDescriptor);
+    }).detach();
+  }
+}
+} // namespace WayoutPlayer
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+
+#include "Solver.hpp"
+#include "ThreadPool.hpp"
+#include "Types.hpp"
+
+namespace WayoutPlayer {
+/**
+ * Solves boards sent by clients on a pool of worker threads which stay warm between boards.
+ *
+ * Requests are boards in the textual input format, optionally preceded by a header line starting with #, and terminated
+ * by an empty line or by the end of the input. Every request is answered by its header, its solution and statistics (or
+ * the exception thrown while solving it) followed by an empty line. Responses are written in the order of the requests.
+ */
+class SolveServer {
+  const Solver &solver;
+  ThreadPool threadPool;
+
+  [[nodiscard]] std::string respond(std::string_view request) const;
+
+public:
+  SolveServer(const Solver &newSolver, U32 threadCount);
+
+  /**
+   * Serves the requests read from the input descriptor until it is closed.
+   */
+  void serve(int inputDescriptor, int outputDescriptor);
+
+  /**
+   * Listens on a Unix domain socket at the path, serving every connection until it is closed.
+   *
+   * Accepting is retried after interruptions and aborted connections, and shortly after running out of descriptors or
+   * memory. Any other failure to accept throws.
+   */
+  [[noreturn]] void listen(const std::string &socketPath);
+};
+} // namespace WayoutPlayer
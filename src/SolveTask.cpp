@@ -0,0 +1,92 @@
+#include "SolveTask.hpp"
+
+#include <stdexcept>
+#include <utility>
+
+namespace WayoutPlayer {
+SolveTask SolveTask::promise_type::get_return_object() {
+  return SolveTask(std::coroutine_handle<promise_type>::from_promise(*this));
+}
+
+std::suspend_always SolveTask::promise_type::initial_suspend() noexcept {
+  return {};
+}
+
+std::suspend_always SolveTask::promise_type::final_suspend() noexcept {
+  return {};
+}
+
+std::suspend_always SolveTask::promise_type::yield_value(const SolveProgress &newProgress) {
+  progress = newProgress;
+  return {};
+}
+
+void SolveTask::promise_type::return_value(Solution newSolution) {
+  solution = std::move(newSolution);
+}
+
+void SolveTask::promise_type::unhandled_exception() {
+  exception = std::current_exception();
+}
+
+SolveTask::SolveTask(std::coroutine_handle<promise_type> coroutineHandle) : handle(coroutineHandle) {
+}
+
+SolveTask::SolveTask(SolveTask &&other) noexcept : handle(std::exchange(other.handle, nullptr)) {
+}
+
+SolveTask &SolveTask::operator=(SolveTask &&other) noexcept {
+  if (this != &other) {
+    if (handle) {
+      handle.destroy();
+    }
+    handle = std::exchange(other.handle, nullptr);
+  }
+  return *this;
+}
+
+SolveTask::~SolveTask() {
+  if (handle) {
+    handle.destroy();
+  }
+}
+
+bool SolveTask::resume() {
+  if (isDone()) {
+    return false;
+  }
+  handle.resume();
+  return !handle.done();
+}
+
+bool SolveTask::isDone() const {
+  return !handle || handle.done();
+}
+
+const SolveProgress &SolveTask::getProgress() const {
+  if (!handle) {
+    throw std::runtime_error("Cannot get the progress of a cancelled solve.");
+  }
+  return handle.promise().progress;
+}
+
+Solution SolveTask::getSolution() const {
+  if (!handle) {
+    throw std::runtime_error("Cannot get the solution of a cancelled solve.");
+  }
+  if (!handle.done()) {
+    throw std::runtime_error("Cannot get the solution of a solve which has not finished.");
+  }
+  if (handle.promise().exception) {
+    std::rethrow_exception(handle.promise().exception);
+  }
+  return *handle.promise().solution;
+}
+
+void SolveTask::cancel() {
+  if (handle) {
+    handle.destroy();
+    handle = nullptr;
+  }
+}
+} // namespace WayoutPlayer
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <optional>
+
+#include "Solution.hpp"
+#include "Types.hpp"
+
+namespace WayoutPlayer {
+/**
+ * How far a solve has come when it reports progress.
+ */
+class SolveProgress {
+public:
+  // The index of the component being solved.
+  U32 component = 0;
+  // The number of clicks of the boards being expanded.
+  S32 depth = 0;
+  std::size_t frontierSize = 0;
+  U64 exploredNodes = 0;
+  F64 nodesPerSecond = 0.0;
+};
+
+/**
+ * A solve which runs only while it is resumed, reporting its progress every so often until it has a solution.
+ *
+ * A solve does nothing until it is first resumed, and destroying it or cancelling it while it is suspended releases
+ * everything it holds. The solver that made it must outlive it.
+ */
+class SolveTask {
+public:
+  class promise_type {
+  public:
+    SolveProgress progress;
+    std::optional<Solution> solution;
+    std::exception_ptr exception;
+
+    SolveTask get_return_object();
+
+    std::suspend_always initial_suspend() noexcept;
+
+    std::suspend_always final_suspend() noexcept;
+
+    std::suspend_always yield_value(const SolveProgress &newProgress);
+
+    void return_value(Solution newSolution);
+
+    void unhandled_exception();
+  };
+
+private:
+  std::coroutine_handle<promise_type> handle;
+
+public:
+  explicit SolveTask(std::coroutine_handle<promise_type> coroutineHandle);
+
+  SolveTask(const SolveTask &) = delete;
+
+  SolveTask &operator=(const SolveTask &) = delete;
+
+  SolveTask(SolveTask &&other) noexcept;
+
+  SolveTask &operator=(SolveTask &&other) noexcept;
+
+  ~SolveTask();
+
+  /**
+   * Runs the solve until it reports progress or finishes, and returns whether or not it is still running.
+   */
+  bool resume();
+
+  [[nodiscard]] bool isDone() const;
+
+  [[nodiscard]] const SolveProgress &getProgress() const;
+
+  /**
+   * Returns the solution of a finished solve, or throws what the solve threw.
+   */
+  [[nodiscard]] Solution getSolution() const;
+
+  /**
+   * Stops the solve. It is then done, and has neither a solution nor an exception.
+   */
+  void cancel();
+};
+} // namespace WayoutPlayer
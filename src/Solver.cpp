@@ -1,13 +1,32 @@
 #include "Solver.hpp"
 
 #include <algorithm>
+#include <chrono>
 #include <iostream>
-#include <queue>
+#include <limits>
+#include <memory_resource>
 #include <unordered_set>
 
+#include "Arena.hpp"
+#include "BoardLayout.hpp"
+#include "BeamSearchEngine.hpp"
+#include "ChasingEngine.hpp"
+#include "Frontier.hpp"
+#include "HybridEngine.hpp"
+#include "IterativeDeepeningEngine.hpp"
+#include "LocalSearchEngine.hpp"
+#include "PackedBoard.hpp"
+#include "SolvabilityCheck.hpp"
+#include "SubsetEnumerationEngine.hpp"
+#include "SystemInformation.hpp"
 #include "Text.hpp"
 
 namespace WayoutPlayer {
+namespace {
+// How many states ahead of the one being expanded should be brought into the cache.
+constexpr std::size_t FrontierPrefetchDistance = 4;
+} // namespace
+
 const SolverConfiguration &Solver::getSolverConfiguration() const {
   return solverConfiguration;
 }
@@ -16,68 +35,115 @@ SolverConfiguration &Solver::getSolverConfiguration() {
   return solverConfiguration;
 }
 
-Solution Solver::findSolutionWithoutSplitting(const Board &initialBoard) const {
+const ComponentCache &Solver::getComponentCache() const {
+  return componentCache;
+}
+
+SolveTask Solver::searchBreadthFirst(Board initialBoard) const {
   if (initialBoard.isSolved()) {
-    return Solution({}, true);
+    co_return Solution({}, true);
   }
-  struct State {
-    Board board;
-    std::vector<Position> clicked;
-
-    void click(IndexType i, IndexType j) {
-      clicked.emplace_back(i, j);
-    }
-
-    [[nodiscard]] bool hasClicked(IndexType i, IndexType j) const {
-      return std::find(std::begin(clicked), std::end(clicked), Position{i, j}) != std::end(clicked);
-    }
-
-    [[nodiscard]] std::vector<Position> getClickPositionVector() const {
-      return clicked;
+  const BoardLayout layout(initialBoard);
+  if (!layout.canBePacked()) {
+    const auto limitString = std::to_string(BoardLayout::MaximumPackedTileCount);
+    throw std::runtime_error("Breadth-first search supports components of at most " + limitString + " tiles.");
+  }
+  // Everything allocated for this search comes from the arena and is released at once when the search ends.
+  Arena arena(getSearchResource(solverConfiguration.getHugePages()));
+  // The frontier and the paths allocate through their own counters, so that the memory of each one can be reported.
+  CountingMemoryResource pathResource(arena.getResource());
+  CountingMemoryResource frontierResource(arena.getResource());
+  // The clicks of every state are stored as a tree of path nodes, so that states only refer to their last click.
+  struct PathNode {
+    U32 parent;
+    S32 index;
+  };
+  const auto NoParent = std::numeric_limits<U32>::max();
+  std::pmr::vector<PathNode> pathNodes(&pathResource);
+  const auto getClickPositionVector = [&layout, &pathNodes, NoParent](U32 pathNode) {
+    std::vector<Position> clicks;
+    for (auto node = pathNode; node != NoParent; node = pathNodes[node].parent) {
+      if (pathNodes[node].index >= 0) {
+        clicks.push_back(layout.getPosition(pathNodes[node].index));
+      }
     }
+    std::reverse(std::begin(clicks), std::end(clicks));
+    return clicks;
   };
-  const auto n = initialBoard.getRowCount();
-  const auto m = initialBoard.getColumnCount();
   struct Hash {
-    std::size_t operator()(const Board &board) const {
+    std::size_t operator()(const PackedBoard &board) const {
       return board.hash();
     }
   };
+  const auto tileCount = layout.getTileCount();
   U64 exploredNodes = 0;
-  State initialState{initialBoard, {}};
-  std::unordered_set<Board, Hash> seenBoards;
+  // The number of clicks of the states being expanded.
+  S32 depth = 0;
+  SearchState initialState{PackedBoard(layout, initialBoard), 0, 0, 0};
+  pathNodes.push_back({NoParent, -1});
+  std::pmr::unordered_set<PackedBoard, Hash> seenBoards(arena.getResource());
   seenBoards.insert(initialState.board);
-  for (S32 i = 0; i < n; i++) {
-    for (S32 j = 0; j < m; j++) {
-      if (initialState.board.hasTile(i, j)) {
-        if (initialState.board.getTile(i, j).type == TileType::Tap && initialState.board.getTile(i, j).up) {
-          initialState.board.activate(i, j);
-          initialState.click(i, j);
-          exploredNodes++;
-          seenBoards.insert(initialState.board);
-        }
-      }
+  for (S32 index = 0; index < tileCount; index++) {
+    if (layout.getType(index) == TileType::Tap && initialState.board.up & (U64{1} << static_cast<U32>(index))) {
+      initialState.board.activate(layout, index);
+      initialState.clicked |= U64{1} << static_cast<U32>(index);
+      pathNodes.push_back({initialState.pathNode, index});
+      initialState.pathNode = static_cast<U32>(pathNodes.size() - 1);
+      exploredNodes++;
+      depth++;
+      seenBoards.insert(initialState.board);
     }
   }
   if (initialState.board.isSolved()) {
-    return Solution(initialState.getClickPositionVector(), true);
+    co_return Solution(getClickPositionVector(initialState.pathNode), true);
   }
-  const auto mayNeedMultipleClicks = initialState.board.mayNeedMultipleClicks();
-  const auto canBeSolvedOptimallyDirectionally = initialState.board.canBeSolvedOptimallyDirectionally();
-  std::queue<State> stateQueue;
-  stateQueue.push(initialState);
-  std::optional<Solution> solution;
+  const auto mayNeedMultipleClicks = initialBoard.mayNeedMultipleClicks();
+  const auto canBeSolvedOptimallyDirectionally = initialBoard.canBeSolvedOptimallyDirectionally();
   const auto configuration = getSolverConfiguration();
+  const auto flippingOnlyUp = configuration.isFlippingOnlyUp();
+  // If clicks commute and no tile needs to be clicked twice, every set of clicks only needs to be tried in one order.
+  // Clicking in increasing row-major order then never generates the permutations of a set of clicks.
+  const auto orderingClicksCanonically = !mayNeedMultipleClicks && !canBeSolvedOptimallyDirectionally &&
+                                         !flippingOnlyUp && initialBoard.hasCommutativeClicks();
+  const auto deduplicatingBoards = !orderingClicksCanonically || configuration.isDeduplicatingCommutativeBoards();
+  // Two clicks on a tile cancel out, and can be removed from a solution, unless the first one unblocked a tile, which
+  // is the only way in which a click changes how later clicks act. Only tiles which reach a blocked tile other than
+  // themselves may then need a second click. This does not hold with twins, whose clicks depend on their state.
+  U64 clickableAgainMask = 0;
+  if (mayNeedMultipleClicks) {
+    const auto clickReaches = layout.computeClickReaches();
+    for (S32 index = 0; index < tileCount; index++) {
+      const auto bit = U64{1} << static_cast<U32>(index);
+      if (layout.getTwinMask() != 0 || (clickReaches[index] & ~bit & initialState.board.blocked) != 0) {
+        clickableAgainMask |= bit;
+      }
+    }
+  }
+  U64 generatedNodes = seenBoards.size();
+  std::optional<Solution> solution;
   const auto maximumStateQueueSize = configuration.getMaximumStateQueueSize();
   const auto maximumBoardHashTableSize = configuration.getMaximumBoardHashTableSize();
-  const auto flippingOnlyUp = configuration.isFlippingOnlyUp();
+  const auto progressInterval = configuration.getProgressInterval();
+  const auto start = std::chrono::steady_clock::now();
+  const auto reportProgress = [&](std::size_t frontierSize) {
+    SolveProgress progress;
+    progress.depth = depth;
+    progress.frontierSize = frontierSize;
+    progress.exploredNodes = exploredNodes;
+    const auto seconds = std::chrono::duration<F64>(std::chrono::steady_clock::now() - start).count();
+    progress.nodesPerSecond = seconds > 0.0 ? static_cast<F64>(exploredNodes) / seconds : 0.0;
+    return progress;
+  };
   if (configuration.isVerbose()) {
     if (canBeSolvedOptimallyDirectionally) {
       std::cout << "Can be solved from any direction." << '\n';
     }
+    if (orderingClicksCanonically) {
+      std::cout << "Clicks commute, so they are tried in canonical order." << '\n';
+    }
   }
-  while (!stateQueue.empty()) {
-    if (stateQueue.size() > maximumStateQueueSize) {
+  const auto checkLimits = [&](std::size_t frontierSize) {
+    if (frontierSize > maximumStateQueueSize) {
       const auto limitString = std::to_string(maximumStateQueueSize);
       throw std::runtime_error("State queue size exceeded the limit of " + limitString + ".");
     }
@@ -85,93 +151,271 @@ Solution Solver::findSolutionWithoutSplitting(const Board &initialBoard) const {
       const auto limitString = std::to_string(maximumBoardHashTableSize);
       throw std::runtime_error("Board hash table size exceeded the limit of " + limitString + ".");
     }
-    const auto state = stateQueue.front();
-    stateQueue.pop();
-    auto derivedState = state;
-    auto exploring = true;
-    for (S32 i = 0; i < n && exploring; i++) {
-      for (S32 j = 0; j < m && exploring; j++) {
-        if (!state.board.hasTile(i, j)) {
-          continue;
-        }
-        if (!mayNeedMultipleClicks && state.hasClicked(i, j)) {
-          continue;
-        }
-        if (state.board.getTile(i, j).type == TileType::Tap) {
-          if (state.board.getTile(i, j).up) {
-            throw std::runtime_error("Should not have up taps during search.");
-          }
-          continue;
-        }
-        if (state.board.getTile(i, j).type == TileType::Blocked) {
-          continue;
+  };
+  // Pushes the successors of the state, and sets the solution if one of them is the first solved board.
+  const auto expand = [&](const SearchState &state, const auto &push) {
+    const auto click = [&](S32 index) {
+      auto derivedState = state;
+      derivedState.board.activate(layout, index);
+      // Only the field the click order needs is set, so that the other one compresses well.
+      if (orderingClicksCanonically) {
+        derivedState.firstClickableIndex = index + 1;
+      } else {
+        derivedState.clicked |= U64{1} << static_cast<U32>(index);
+      }
+      const auto isNew = !deduplicatingBoards || seenBoards.insert(derivedState.board).second;
+      const auto isFirstSolution = !solution && derivedState.board.isSolved();
+      if (isNew || isFirstSolution) {
+        pathNodes.push_back({state.pathNode, index});
+        derivedState.pathNode = static_cast<U32>(pathNodes.size() - 1);
+      }
+      if (isFirstSolution) {
+        solution = Solution(getClickPositionVector(derivedState.pathNode), !flippingOnlyUp);
+      }
+      if (isNew) {
+        push(derivedState);
+        generatedNodes++;
+      }
+    };
+    const auto clickTileIfExists = [&click](S32 index) {
+      if (index >= 0) {
+        click(index);
+      }
+    };
+    const auto considerClickingTileAndNeighbors = [&layout, &clickTileIfExists](S32 center) {
+      clickTileIfExists(center);
+      for (const auto neighbor : layout.getNeighbors(center)) {
+        clickTileIfExists(neighbor);
+      }
+    };
+    const auto firstIndex = orderingClicksCanonically ? state.firstClickableIndex : 0;
+    for (S32 index = firstIndex; index < tileCount; index++) {
+      if (state.hasClicked(index) && (clickableAgainMask & (U64{1} << static_cast<U32>(index))) == 0) {
+        continue;
+      }
+      const auto type = state.board.getType(layout, index);
+      const auto up = (state.board.up & (U64{1} << static_cast<U32>(index))) != 0;
+      if (type == TileType::Tap) {
+        if (up) {
+          throw std::runtime_error("Should not have up taps during search.");
         }
-        if (flippingOnlyUp) {
-          if (!state.board.getTile(i, j).up) {
-            continue;
-          }
+        continue;
+      }
+      if (type == TileType::Blocked) {
+        continue;
+      }
+      if (flippingOnlyUp && !up) {
+        continue;
+      }
+      if (canBeSolvedOptimallyDirectionally) {
+        // Temporary: if we can solve this directionally, don't try all possible clicks for a board.
+        if (up) {
+          considerClickingTileAndNeighbors(index);
+          break;
         }
-        const auto click = [&solution, &derivedState, &state, flippingOnlyUp, &stateQueue, &seenBoards](S32 i, S32 j) {
-          derivedState.board = state.board;
-          derivedState.board.activate(i, j);
-          derivedState.click(i, j);
-          if (!solution && derivedState.board.isSolved()) {
-            solution = Solution(derivedState.getClickPositionVector(), !flippingOnlyUp);
-          }
-          if (seenBoards.count(derivedState.board) == 0) {
-            stateQueue.push(derivedState);
-            seenBoards.insert(derivedState.board);
-          }
-          derivedState.clicked.pop_back();
-        };
-        const auto clickTileIfExists = [&state, &click](S32 i, S32 j) {
-          if (state.board.hasTile(i, j)) {
-            click(i, j);
+      } else {
+        clickTileIfExists(index);
+      }
+    }
+  };
+  const auto finishSearch = [&]() {
+    solution->setExploredNodes(exploredNodes);
+    solution->setDistinctNodes(generatedNodes);
+    solution->setArenaReservedBytes(arena.getReservedBytes());
+    solution->setArenaUsedBytes(arena.getPeakUsedBytes());
+    auto &memoryBreakdown = solution->getMemoryBreakdown();
+    memoryBreakdown.frontierBytes = frontierResource.getPeakBytes();
+    memoryBreakdown.seenBoardBytes = estimateHashSetBytes(seenBoards);
+    memoryBreakdown.pathBytes = pathResource.getPeakBytes();
+    return solution.value();
+  };
+  if (configuration.isCompressingFrontier()) {
+    LayeredFrontier frontier(&frontierResource);
+    std::pmr::vector<SearchState> states(&frontierResource);
+    const auto push = [&frontier](const SearchState &derivedState) { frontier.push(derivedState); };
+    frontier.push(initialState);
+    frontier.advanceLayer();
+    while (!frontier.isEmpty()) {
+      while (frontier.popBlock(states)) {
+        for (const auto &state : states) {
+          checkLimits(frontier.getSize());
+          expand(state, push);
+          exploredNodes++;
+          if (solution) {
+            co_return finishSearch();
           }
-        };
-        const auto considerClickingTileAndNeighbors = [&clickTileIfExists](S32 centerI, S32 centerJ) {
-          clickTileIfExists(centerI, centerJ);
-          clickTileIfExists(centerI - 1, centerJ);
-          clickTileIfExists(centerI, centerJ - 1);
-          clickTileIfExists(centerI, centerJ + 1);
-          clickTileIfExists(centerI + 1, centerJ);
-        };
-        if (canBeSolvedOptimallyDirectionally) {
-          // Temporary: if we can solve this directionally, don't try all possible clicks for a board.
-          if (state.board.getTile(i, j).up || state.board.getTile(i, j).type == TileType::Blocked) {
-            considerClickingTileAndNeighbors(i, j);
-            exploring = false;
+          if (exploredNodes % progressInterval == 0) {
+            co_yield reportProgress(frontier.getSize());
           }
-        } else {
-          clickTileIfExists(i, j);
         }
       }
+      frontier.advanceLayer();
+      depth++;
     }
-    exploredNodes++;
-    if (solution) {
-      solution->setExploredNodes(exploredNodes);
-      solution->setDistinctNodes(seenBoards.size());
-      return solution.value();
+  } else {
+    Frontier frontier(&frontierResource);
+    const auto push = [&frontier](const SearchState &derivedState) { frontier.push(derivedState); };
+    frontier.push(initialState);
+    std::size_t statesLeftInLayer = 1;
+    while (!frontier.isEmpty()) {
+      checkLimits(frontier.getSize());
+      // The front state is read in place and only popped after all of its successors have been pushed.
+      frontier.prefetch(FrontierPrefetchDistance);
+      expand(frontier.front(), push);
+      frontier.pop();
+      exploredNodes++;
+      if (solution) {
+        co_return finishSearch();
+      }
+      if (--statesLeftInLayer == 0) {
+        statesLeftInLayer = frontier.getSize();
+        depth++;
+      }
+      if (exploredNodes % progressInterval == 0) {
+        co_yield reportProgress(frontier.getSize());
+      }
     }
   }
   const auto exploredNodeCount = toPluralizedString(exploredNodes, "node");
   throw std::runtime_error("Could not find a solution after exploring " + exploredNodeCount + ".");
 }
 
-Solution Solver::findSolution(const Board &initialBoard) const {
+SolveTask Solver::solveComponent(Board initialBoard) const {
+  const auto &configuration = getSolverConfiguration();
+  const SubsetEnumerationEngine subsetEnumerationEngine(configuration);
+  const HybridEngine hybridEngine(configuration);
+  const ChasingEngine chasingEngine(configuration);
+  const BoardLayout layout(initialBoard);
+  const auto &endgameTableDirectory = configuration.getEndgameTableDirectory();
+  std::optional<SolveTask> search;
+  switch (configuration.getEngine()) {
+  case SolverEngine::BreadthFirst:
+    search.emplace(searchBreadthFirst(initialBoard));
+    break;
+  case SolverEngine::SubsetEnumeration:
+    co_return subsetEnumerationEngine.findSolution(initialBoard);
+  case SolverEngine::IterativeDeepening:
+    co_return IterativeDeepeningEngine(configuration).findSolution(initialBoard);
+  case SolverEngine::LocalSearch:
+    co_return LocalSearchEngine(configuration).findSolution(initialBoard);
+  case SolverEngine::Hybrid:
+    search.emplace(hybridEngine.solve(initialBoard));
+    break;
+  case SolverEngine::EndgameTable:
+    co_return endgameTables.get(layout, endgameTableDirectory)->findSolution(layout, initialBoard);
+  case SolverEngine::Chasing:
+    co_return chasingEngine.findSolution(initialBoard);
+  case SolverEngine::BeamSearch:
+    co_return BeamSearchEngine(configuration).findSolution(initialBoard);
+  case SolverEngine::Automatic:
+    // Tables are only worth building when they are kept for later runs.
+    if (!configuration.isFlippingOnlyUp() && !endgameTableDirectory.empty() && EndgameTable::canBeBuilt(layout)) {
+      co_return endgameTables.get(layout, endgameTableDirectory)->findSolution(layout, initialBoard);
+    }
+    // Only chasing scales to boards too large to be packed.
+    if (!configuration.isFlippingOnlyUp() && !layout.canBePacked() && chasingEngine.canSolve(initialBoard)) {
+      co_return chasingEngine.findSolution(initialBoard);
+    }
+    // Exact search cannot represent the rest, so they get a solution which may not be optimal.
+    if (!layout.canBePacked()) {
+      co_return BeamSearchEngine(configuration).findSolution(initialBoard);
+    }
+    if (!configuration.isFlippingOnlyUp() && hybridEngine.canSolve(initialBoard)) {
+      search.emplace(hybridEngine.solve(initialBoard));
+    } else if (!configuration.isFlippingOnlyUp() && subsetEnumerationEngine.canSolve(initialBoard) &&
+               static_cast<U32>(layout.getTileCount()) <=
+                   configuration.getMaximumSubsetEnumerationTileCount()) {
+      co_return subsetEnumerationEngine.findSolution(initialBoard);
+    } else {
+      search.emplace(searchBreadthFirst(initialBoard));
+    }
+    break;
+  }
+  while (search->resume()) {
+    co_yield search->getProgress();
+  }
+  co_return search->getSolution();
+}
+
+SolveTask Solver::solve(Board initialBoard) const {
   const auto components = initialBoard.splitComponents();
   if (getSolverConfiguration().isVerbose()) {
     std::cout << "Found " << toPluralizedString(components.size(), "component") << "." << '\n';
   }
+  const auto componentCacheSize = getSolverConfiguration().getComponentCacheSize();
   std::optional<Solution> solution;
-  for (const auto &component : components) {
-    const auto componentSolution = findSolutionWithoutSplitting(component);
+  const auto addComponentSolution = [&solution](const Solution &componentSolution) {
     if (solution) {
       solution->add(componentSolution);
     } else {
       solution = componentSolution;
     }
+  };
+  // Searching a component which cannot be solved would explore every board reachable from it before giving up.
+  for (const auto &component : components) {
+    if (const auto reason = findUnsolvabilityReason(component)) {
+      throw std::runtime_error(*reason);
+    }
+  }
+  for (U32 componentIndex = 0; componentIndex < components.size(); componentIndex++) {
+    std::optional<NormalizedComponent> normalizedComponent;
+    if (componentCacheSize > 0) {
+      normalizedComponent = NormalizedComponent::fromBoard(components[componentIndex], getSolverConfiguration());
+      if (const auto clicks = componentCache.find(*normalizedComponent)) {
+        if (getSolverConfiguration().isVerbose()) {
+          std::cout << "Found component " << componentIndex + 1 << " among the components solved before." << '\n';
+        }
+        Solution cachedSolution(*clicks, true);
+        cachedSolution.setExploredNodes(0);
+        cachedSolution.setDistinctNodes(0);
+        addComponentSolution(cachedSolution);
+        continue;
+      }
+    }
+    std::optional<ResourceSampler> sampler;
+    std::optional<PerformanceCounters> performanceCounters;
+    if (getSolverConfiguration().isSamplingResources()) {
+      sampler.emplace();
+      performanceCounters.emplace();
+    }
+    auto componentSolve = solveComponent(components[componentIndex]);
+    while (componentSolve.resume()) {
+      auto progress = componentSolve.getProgress();
+      progress.component = componentIndex;
+      co_yield progress;
+    }
+    auto componentSolution = componentSolve.getSolution();
+    if (sampler) {
+      auto &memoryBreakdown = componentSolution.getMemoryBreakdown();
+      memoryBreakdown.residentSetSizeBytes = sampler->getPeakResidentSetSizeInBytes();
+      memoryBreakdown.minorPageFaults = sampler->getMinorPageFaults();
+      memoryBreakdown.majorPageFaults = sampler->getMajorPageFaults();
+    }
+    if (performanceCounters) {
+      if (const auto hardwareCounts = performanceCounters->read()) {
+        componentSolution.setHardwareCounts(*hardwareCounts);
+      }
+    }
+    // Only optimal solutions are remembered, so that finding a component again never gives a worse solution.
+    if (normalizedComponent && componentSolution.isOptimal()) {
+      componentCache.insert(*normalizedComponent, componentSolution.getClicks(), componentCacheSize);
+    }
+    addComponentSolution(componentSolution);
+    // Engines which do not report progress can still be interrupted between components.
+    if (componentIndex + 1 < components.size()) {
+      SolveProgress progress;
+      progress.component = componentIndex;
+      progress.exploredNodes = componentSolution.getExploredNodes().value_or(0);
+      co_yield progress;
+    }
+  }
+  co_return *solution;
+}
+
+Solution Solver::findSolution(const Board &initialBoard) const {
+  auto task = solve(initialBoard);
+  while (task.resume()) {
   }
-  return *solution;
+  return task.getSolution();
 }
 } // namespace WayoutPlayer
@@ -1,19 +1,35 @@
 #pragma once
 
 #include "Board.hpp"
+#include "ComponentCache.hpp"
+#include "EndgameTable.hpp"
+#include "SolveTask.hpp"
 #include "SolverConfiguration.hpp"
 
 namespace WayoutPlayer {
 class Solver {
   SolverConfiguration solverConfiguration;
+  // Shared by all the boards solved by this solver.
+  mutable ComponentCache componentCache;
+  mutable EndgameTableCache endgameTables;
 
-  [[nodiscard]] Solution findSolutionWithoutSplitting(const Board &initialState) const;
+  [[nodiscard]] SolveTask searchBreadthFirst(Board initialBoard) const;
+
+  [[nodiscard]] SolveTask solveComponent(Board initialBoard) const;
 
 public:
   [[nodiscard]] const SolverConfiguration &getSolverConfiguration() const;
 
   [[nodiscard]] SolverConfiguration &getSolverConfiguration();
 
+  [[nodiscard]] const ComponentCache &getComponentCache() const;
+
+  /**
+   * Returns a solve of the board which reports its progress after every component, and every so many nodes expanded by
+   * the breadth-first and hybrid searches. The solver must outlive the solve.
+   */
+  [[nodiscard]] SolveTask solve(Board initialBoard) const;
+
   [[nodiscard]] Solution findSolution(const Board &initialState) const;
 };
 } // namespace WayoutPlayer
\ No newline at end of file
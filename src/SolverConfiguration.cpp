@@ -1,5 +1,7 @@
 #include "SolverConfiguration.hpp"
 
+#include <stdexcept>
+
 namespace WayoutPlayer {
 std::size_t SolverConfiguration::getMaximumBoardHashTableSize() const {
   return maximumBoardHashTableSize;
@@ -17,6 +19,132 @@ void SolverConfiguration::setMaximumStateQueueSize(std::size_t newMaximumStateQu
   maximumStateQueueSize = newMaximumStateQueueSize;
 }
 
+U64 SolverConfiguration::getProgressInterval() const {
+  return progressInterval;
+}
+
+void SolverConfiguration::setProgressInterval(U64 newProgressInterval) {
+  if (newProgressInterval == 0) {
+    throw std::invalid_argument("The progress interval must be positive.");
+  }
+  progressInterval = newProgressInterval;
+}
+
+std::size_t SolverConfiguration::getComponentCacheSize() const {
+  return componentCacheSize;
+}
+
+void SolverConfiguration::setComponentCacheSize(std::size_t newComponentCacheSize) {
+  componentCacheSize = newComponentCacheSize;
+}
+
+SolverEngine SolverConfiguration::getEngine() const {
+  return engine;
+}
+
+void SolverConfiguration::setEngine(SolverEngine newEngine) {
+  engine = newEngine;
+}
+
+HugePages SolverConfiguration::getHugePages() const {
+  return hugePages;
+}
+
+void SolverConfiguration::setHugePages(HugePages newHugePages) {
+  hugePages = newHugePages;
+}
+
+U32 SolverConfiguration::getThreadCount() const {
+  return threadCount;
+}
+
+void SolverConfiguration::setThreadCount(U32 newThreadCount) {
+  threadCount = newThreadCount;
+}
+
+std::size_t SolverConfiguration::getTranspositionTableSize() const {
+  return transpositionTableSize;
+}
+
+void SolverConfiguration::setTranspositionTableSize(size_t newTranspositionTableSize) {
+  transpositionTableSize = newTranspositionTableSize;
+}
+
+bool SolverConfiguration::isUsingPatternDatabases() const {
+  return usePatternDatabases;
+}
+
+void SolverConfiguration::setUsePatternDatabases(bool newUsePatternDatabases) {
+  usePatternDatabases = newUsePatternDatabases;
+}
+
+const std::string &SolverConfiguration::getPatternDatabaseDirectory() const {
+  return patternDatabaseDirectory;
+}
+
+void SolverConfiguration::setPatternDatabaseDirectory(const std::string &newPatternDatabaseDirectory) {
+  patternDatabaseDirectory = newPatternDatabaseDirectory;
+}
+
+const std::string &SolverConfiguration::getEndgameTableDirectory() const {
+  return endgameTableDirectory;
+}
+
+void SolverConfiguration::setEndgameTableDirectory(const std::string &newEndgameTableDirectory) {
+  endgameTableDirectory = newEndgameTableDirectory;
+}
+
+std::chrono::milliseconds SolverConfiguration::getLocalSearchTimeBudget() const {
+  return localSearchTimeBudget;
+}
+
+void SolverConfiguration::setLocalSearchTimeBudget(std::chrono::milliseconds newLocalSearchTimeBudget) {
+  localSearchTimeBudget = newLocalSearchTimeBudget;
+}
+
+U32 SolverConfiguration::getMaximumSubsetEnumerationTileCount() const {
+  return maximumSubsetEnumerationTileCount;
+}
+
+void SolverConfiguration::setMaximumSubsetEnumerationTileCount(U32 newMaximumSubsetEnumerationTileCount) {
+  maximumSubsetEnumerationTileCount = newMaximumSubsetEnumerationTileCount;
+}
+
+U32 SolverConfiguration::getBeamWidth() const {
+  return beamWidth;
+}
+
+void SolverConfiguration::setBeamWidth(U32 newBeamWidth) {
+  if (newBeamWidth == 0) {
+    throw std::invalid_argument("The beam width must be positive.");
+  }
+  beamWidth = newBeamWidth;
+}
+
+std::chrono::milliseconds SolverConfiguration::getBeamSearchTimeBudget() const {
+  return beamSearchTimeBudget;
+}
+
+void SolverConfiguration::setBeamSearchTimeBudget(std::chrono::milliseconds newBeamSearchTimeBudget) {
+  beamSearchTimeBudget = newBeamSearchTimeBudget;
+}
+
+bool SolverConfiguration::isDeduplicatingCommutativeBoards() const {
+  return deduplicateCommutativeBoards;
+}
+
+void SolverConfiguration::setDeduplicateCommutativeBoards(bool newDeduplicateCommutativeBoards) {
+  deduplicateCommutativeBoards = newDeduplicateCommutativeBoards;
+}
+
+bool SolverConfiguration::isCompressingFrontier() const {
+  return compressFrontier;
+}
+
+void SolverConfiguration::setCompressFrontier(bool newCompressFrontier) {
+  compressFrontier = newCompressFrontier;
+}
+
 bool SolverConfiguration::isFlippingOnlyUp() const {
   return flipOnlyUp;
 }
@@ -25,6 +153,14 @@ void SolverConfiguration::setFlipOnlyUp(bool newFlipOnlyUp) {
   flipOnlyUp = newFlipOnlyUp;
 }
 
+bool SolverConfiguration::isSamplingResources() const {
+  return sampleResources;
+}
+
+void SolverConfiguration::setSampleResources(bool newSampleResources) {
+  sampleResources = newSampleResources;
+}
+
 bool SolverConfiguration::isVerbose() const {
   return verbose;
 }
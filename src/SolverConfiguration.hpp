@@ -1,13 +1,35 @@
 #pragma once
 
+#include <chrono>
 #include <string>
 
+#include "Arena.hpp"
+#include "SolverEngine.hpp"
+#include "Types.hpp"
+
 namespace WayoutPlayer {
 class SolverConfiguration {
   std::size_t maximumBoardHashTableSize = 1u << 30u;
   std::size_t maximumStateQueueSize = 1u << 30u;
+  std::size_t transpositionTableSize = 0;
+  std::string patternDatabaseDirectory;
+  std::string endgameTableDirectory;
+  std::chrono::milliseconds localSearchTimeBudget{1000};
+  U64 progressInterval = 1u << 16u;
+  std::size_t componentCacheSize = 0;
+
+  SolverEngine engine = SolverEngine::Automatic;
+  HugePages hugePages = HugePages::Off;
+  U32 threadCount = 1;
+  U32 maximumSubsetEnumerationTileCount = 30;
+  U32 beamWidth = 1024;
+  std::chrono::milliseconds beamSearchTimeBudget{10000};
 
+  bool deduplicateCommutativeBoards = false;
+  bool compressFrontier = true;
+  bool usePatternDatabases = true;
   bool flipOnlyUp = false;
+  bool sampleResources = false;
   bool verbose = false;
 
 public:
@@ -17,9 +39,103 @@ public:
   [[nodiscard]] std::size_t getMaximumStateQueueSize() const;
   void setMaximumStateQueueSize(size_t newMaximumStateQueueSize);
 
+  /**
+   * How many boards iterative deepening may remember across all threads, or zero to remember none.
+   */
+  [[nodiscard]] std::size_t getTranspositionTableSize() const;
+  void setTranspositionTableSize(size_t newTranspositionTableSize);
+
+  /**
+   * Whether or not informed searches build pattern databases for boards which support them.
+   */
+  [[nodiscard]] bool isUsingPatternDatabases() const;
+  void setUsePatternDatabases(bool newUsePatternDatabases);
+
+  /**
+   * Where pattern databases are stored to be reused, or empty to build them for every board.
+   */
+  [[nodiscard]] const std::string &getPatternDatabaseDirectory() const;
+  void setPatternDatabaseDirectory(const std::string &newPatternDatabaseDirectory);
+
+  /**
+   * Where endgame tables are stored to be reused, or empty to only use them when they are the chosen engine.
+   */
+  [[nodiscard]] const std::string &getEndgameTableDirectory() const;
+  void setEndgameTableDirectory(const std::string &newEndgameTableDirectory);
+
+  /**
+   * How long local search may spend improving the solution of a component.
+   */
+  [[nodiscard]] std::chrono::milliseconds getLocalSearchTimeBudget() const;
+  void setLocalSearchTimeBudget(std::chrono::milliseconds newLocalSearchTimeBudget);
+
+  /**
+   * How many nodes a solve expands between reports of its progress.
+   */
+  [[nodiscard]] U64 getProgressInterval() const;
+  void setProgressInterval(U64 newProgressInterval);
+
+  /**
+   * How many bytes the solutions of components solved before may take, or zero to always search components anew.
+   */
+  [[nodiscard]] std::size_t getComponentCacheSize() const;
+  void setComponentCacheSize(std::size_t newComponentCacheSize);
+
+  [[nodiscard]] SolverEngine getEngine() const;
+  void setEngine(SolverEngine newEngine);
+
+  /**
+   * How the seen boards, frontiers and paths of the searches are backed by pages.
+   */
+  [[nodiscard]] HugePages getHugePages() const;
+  void setHugePages(HugePages newHugePages);
+
+  [[nodiscard]] U32 getThreadCount() const;
+  void setThreadCount(U32 newThreadCount);
+
+  /**
+   * The automatic engine selection only enumerates subsets of clicks on boards with at most this many tiles.
+   */
+  [[nodiscard]] U32 getMaximumSubsetEnumerationTileCount() const;
+  void setMaximumSubsetEnumerationTileCount(U32 newMaximumSubsetEnumerationTileCount);
+
+  /**
+   * How many boards beam search keeps after every click.
+   */
+  [[nodiscard]] U32 getBeamWidth() const;
+  void setBeamWidth(U32 newBeamWidth);
+
+  /**
+   * How long beam search may spend on a component before giving up.
+   */
+  [[nodiscard]] std::chrono::milliseconds getBeamSearchTimeBudget() const;
+  void setBeamSearchTimeBudget(std::chrono::milliseconds newBeamSearchTimeBudget);
+
+  /**
+   * Whether or not the breadth-first search keeps a set of seen boards when clicks are generated in canonical order.
+   *
+   * Canonical order never generates the same set of clicks twice, so the set only removes different sets of clicks
+   * with the same effect.
+   */
+  [[nodiscard]] bool isDeduplicatingCommutativeBoards() const;
+  void setDeduplicateCommutativeBoards(bool newDeduplicateCommutativeBoards);
+
+  /**
+   * Whether or not the breadth-first search stores its frontier compressed, which takes less memory and a little time.
+   */
+  [[nodiscard]] bool isCompressingFrontier() const;
+  void setCompressFrontier(bool newCompressFrontier);
+
   [[nodiscard]] bool isFlippingOnlyUp() const;
   void setFlipOnlyUp(bool newFlipOnlyUp);
 
+  /**
+   * Whether or not the peak resident set size and the page faults of every component are sampled while it is solved,
+   * and the hardware events of the solving thread are counted where the kernel allows it.
+   */
+  [[nodiscard]] bool isSamplingResources() const;
+  void setSampleResources(bool newSampleResources);
+
   [[nodiscard]] bool isVerbose() const;
   void setVerbose(bool newVerbose);
 };
@@ -0,0 +1,36 @@
+#include "SolverEngine.hpp"
+
+namespace WayoutPlayer {
+std::string solverEngineToString(SolverEngine solverEngine) {
+  switch (solverEngine) {
+  case SolverEngine::Automatic:
+    return "automatic";
+  case SolverEngine::BreadthFirst:
+    return "breadth-first";
+  case SolverEngine::SubsetEnumeration:
+    return "subset-enumeration";
+  case SolverEngine::IterativeDeepening:
+    return "iterative-deepening";
+  case SolverEngine::LocalSearch:
+    return "local-search";
+  case SolverEngine::Hybrid:
+    return "hybrid";
+  case SolverEngine::EndgameTable:
+    return "endgame-table";
+  case SolverEngine::Chasing:
+    return "chasing";
+  case SolverEngine::BeamSearch:
+    return "beam-search";
+  }
+  throw std::invalid_argument("Should not be reachable.");
+}
+
+SolverEngine solverEngineFromString(const std::string &string) {
+  for (const auto solverEngine : SolverEngines) {
+    if (solverEngineToString(solverEngine) == string) {
+      return solverEngine;
+    }
+  }
+  throw std::invalid_argument("Invalid solver engine: " + string + ".");
+}
+} // namespace WayoutPlayer
@@ -0,0 +1,30 @@
+#pragma once
+
+#include "Types.hpp"
+
+#include <array>
+#include <stdexcept>
+#include <string>
+
+namespace WayoutPlayer {
+enum class SolverEngine : U8 {
+  Automatic,
+  BreadthFirst,
+  SubsetEnumeration,
+  IterativeDeepening,
+  LocalSearch,
+  Hybrid,
+  EndgameTable,
+  Chasing,
+  BeamSearch
+};
+
+constexpr std::array<SolverEngine, 9> SolverEngines = {
+    SolverEngine::Automatic,          SolverEngine::BreadthFirst, SolverEngine::SubsetEnumeration,
+    SolverEngine::IterativeDeepening, SolverEngine::LocalSearch,  SolverEngine::Hybrid,
+    SolverEngine::EndgameTable,       SolverEngine::Chasing,      SolverEngine::BeamSearch};
+
+std::string solverEngineToString(SolverEngine solverEngine);
+
+SolverEngine solverEngineFromString(const std::string &string);
+} // namespace WayoutPlayer
@@ -0,0 +1,145 @@
+#include "SubsetEnumerationEngine.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <thread>
+
+#include "BoardLayout.hpp"
+#include "RevolvingDoor.hpp"
+#include "Text.hpp"
+
+namespace WayoutPlayer {
+namespace {
+// Splitting small levels across threads costs more than it saves.
+constexpr U64 MinimumCombinationsPerThread = 1u << 16u;
+
+struct LevelResult {
+  std::optional<U64> solutionRank;
+  U64 visitedCombinations = 0;
+};
+
+/**
+ * Walks combinations of the given size with ranks in [firstRank, lastRank).
+ *
+ * Stops early once a solution with a smaller rank than the current one has been found by any worker.
+ */
+void walkCombinations(const std::vector<U64> &effects, U64 target, S32 size, U64 firstRank, U64 lastRank,
+                      std::atomic<U64> &bestRank, U64 &visitedCombinations) {
+  const auto n = static_cast<S32>(effects.size());
+  RevolvingDoorCombination combination(n, size, firstRank);
+  U64 state = 0;
+  for (const auto element : combination.getElements()) {
+    state ^= effects[element];
+  }
+  for (auto rank = firstRank; rank < lastRank; rank++) {
+    if (bestRank.load(std::memory_order_relaxed) < rank) {
+      return;
+    }
+    visitedCombinations++;
+    if (state == target) {
+      auto currentBest = bestRank.load();
+      while (rank < currentBest && !bestRank.compare_exchange_weak(currentBest, rank)) {
+      }
+      return;
+    }
+    S32 removed = 0;
+    S32 added = 0;
+    if (!combination.next(removed, added)) {
+      return;
+    }
+    state ^= effects[removed] ^ effects[added];
+  }
+}
+
+LevelResult walkLevel(const std::vector<U64> &effects, U64 target, S32 size, U32 threadCount) {
+  const auto n = static_cast<S32>(effects.size());
+  const auto combinationCount = binomialCoefficient(n, size);
+  const auto usefulThreadCount = std::max<U64>(1, combinationCount / MinimumCombinationsPerThread);
+  const auto workerCount = static_cast<U32>(std::min<U64>(std::max<U32>(1, threadCount), usefulThreadCount));
+  std::atomic<U64> bestRank = std::numeric_limits<U64>::max();
+  std::vector<U64> visitedCombinations(workerCount);
+  const auto rangeBegin = [combinationCount, workerCount](U32 worker) {
+    return static_cast<U64>(static_cast<unsigned __int128>(combinationCount) * worker / workerCount);
+  };
+  if (workerCount == 1) {
+    walkCombinations(effects, target, size, 0, combinationCount, bestRank, visitedCombinations[0]);
+  } else {
+    std::vector<std::thread> workers;
+    for (U32 worker = 0; worker < workerCount; worker++) {
+      const auto first = rangeBegin(worker);
+      const auto last = rangeBegin(worker + 1);
+      auto &visited = visitedCombinations[worker];
+      workers.emplace_back([&effects, target, size, first, last, &bestRank, &visited]() {
+        walkCombinations(effects, target, size, first, last, bestRank, visited);
+      });
+    }
+    for (auto &worker : workers) {
+      worker.join();
+    }
+  }
+  LevelResult result;
+  for (const auto visited : visitedCombinations) {
+    result.visitedCombinations += visited;
+  }
+  if (bestRank.load() != std::numeric_limits<U64>::max()) {
+    result.solutionRank = bestRank.load();
+  }
+  return result;
+}
+} // namespace
+
+SubsetEnumerationEngine::SubsetEnumerationEngine(const SolverConfiguration &configuration)
+    : solverConfiguration(configuration) {
+}
+
+bool SubsetEnumerationEngine::canSolve(const Board &board) const {
+  if (!board.hasCommutativeClicks()) {
+    return false;
+  }
+  const BoardLayout layout(board);
+  return layout.canBePacked();
+}
+
+Solution SubsetEnumerationEngine::findSolution(const Board &board) const {
+  if (!canSolve(board)) {
+    throw std::invalid_argument("Subset enumeration requires a board with commutative clicks.");
+  }
+  const BoardLayout layout(board);
+  const auto allEffects = layout.computeClickEffects(board);
+  std::vector<Position> forcedClicks;
+  auto target = layout.getUpMask(board);
+  for (const auto index : layout.findRaisedTaps(target)) {
+    forcedClicks.push_back(layout.getPosition(index));
+    target ^= allEffects[index];
+  }
+  std::vector<S32> freeIndices;
+  for (S32 index = 0; index < layout.getTileCount(); index++) {
+    if (layout.getType(index) != TileType::Tap) {
+      freeIndices.push_back(index);
+    }
+  }
+  std::vector<U64> effects;
+  for (const auto index : freeIndices) {
+    effects.push_back(allEffects[index]);
+  }
+  const auto n = static_cast<S32>(effects.size());
+  U64 exploredNodes = 0;
+  for (S32 size = 0; size <= n; size++) {
+    const auto levelResult = walkLevel(effects, target, size, solverConfiguration.getThreadCount());
+    exploredNodes += levelResult.visitedCombinations;
+    if (levelResult.solutionRank) {
+      const RevolvingDoorCombination combination(n, size, *levelResult.solutionRank);
+      auto clicks = forcedClicks;
+      for (const auto element : combination.getElements()) {
+        clicks.push_back(layout.getPosition(freeIndices[element]));
+      }
+      Solution solution(clicks, true);
+      solution.setExploredNodes(exploredNodes);
+      return solution;
+    }
+  }
+  const auto exploredNodeCount = toPluralizedString(exploredNodes, "node");
+  throw std::runtime_error("Could not find a solution after exploring " + exploredNodeCount + ".");
+}
+} // namespace WayoutPlayer
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <optional>
+
+#include "Board.hpp"
+#include "Solution.hpp"
+#include "SolverConfiguration.hpp"
+
+namespace WayoutPlayer {
+/**
+ * Finds minimum solutions for boards with commutative clicks by enumerating sets of clicks.
+ *
+ * On such boards a solution is a set of clicks, so sets are visited in order of increasing size. Each size is walked
+ * with the revolving-door Gray code, so moving to the next set costs two exclusive-ors and no visited set is stored.
+ */
+class SubsetEnumerationEngine {
+  const SolverConfiguration &solverConfiguration;
+
+public:
+  explicit SubsetEnumerationEngine(const SolverConfiguration &configuration);
+
+  /**
+   * Returns whether or not this engine can solve the board.
+   */
+  [[nodiscard]] bool canSolve(const Board &board) const;
+
+  [[nodiscard]] Solution findSolution(const Board &board) const;
+};
+} // namespace WayoutPlayer
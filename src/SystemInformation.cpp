@@ -2,12 +2,23 @@
 
 #include "Text.hpp"
 
+#include <array>
 #include <cmath>
+#include <fstream>
 #include <iomanip>
 #include <iostream>
 #include <sstream>
+#include <tuple>
 #include <vector>
 
+#include <unistd.h>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#endif
+
 namespace WayoutPlayer {
 SystemInformation::SystemInformation() {
 #ifdef __linux__
@@ -52,4 +63,121 @@ std::string SystemInformation::getMaximumResidentSetSizeAsHumanReadableString()
   stream << ")";
   return stream.str();
 }
+
+U64 SystemInformation::getCurrentResidentSetSizeInBytes() {
+#ifdef __linux__
+  // The second field of statm is the number of resident pages.
+  std::ifstream statm("/proc/self/statm");
+  U64 sizeInPages = 0;
+  U64 residentPages = 0;
+  if (statm >> sizeInPages >> residentPages) {
+    return residentPages * static_cast<U64>(sysconf(_SC_PAGESIZE));
+  }
+#endif
+  return 0;
+}
+
+std::pair<U64, U64> SystemInformation::getPageFaults() {
+#ifdef __linux__
+  rusage resourceUsage{};
+  if (getrusage(RUSAGE_SELF, &resourceUsage) == 0) {
+    return {resourceUsage.ru_minflt, resourceUsage.ru_majflt};
+  }
+#endif
+  return {0, 0};
+}
+
+ResourceSampler::ResourceSampler(std::chrono::milliseconds interval) {
+  std::tie(initialMinorPageFaults, initialMajorPageFaults) = SystemInformation::getPageFaults();
+  sample();
+  thread = std::thread([this, interval]() {
+    std::unique_lock lock(mutex);
+    while (!stopped.wait_for(lock, interval, [this]() { return stopping; })) {
+      sample();
+    }
+  });
+}
+
+ResourceSampler::~ResourceSampler() {
+  {
+    const std::lock_guard lock(mutex);
+    stopping = true;
+  }
+  stopped.notify_one();
+  thread.join();
+}
+
+void ResourceSampler::sample() {
+  const auto current = SystemInformation::getCurrentResidentSetSizeInBytes();
+  auto peak = peakResidentSetSize.load();
+  while (current > peak && !peakResidentSetSize.compare_exchange_weak(peak, current)) {
+  }
+}
+
+U64 ResourceSampler::getPeakResidentSetSizeInBytes() {
+  sample();
+  return peakResidentSetSize.load();
+}
+
+U64 ResourceSampler::getMinorPageFaults() const {
+  return SystemInformation::getPageFaults().first - initialMinorPageFaults;
+}
+
+U64 ResourceSampler::getMajorPageFaults() const {
+  return SystemInformation::getPageFaults().second - initialMajorPageFaults;
+}
+
+PerformanceCounters::PerformanceCounters() {
+#ifdef __linux__
+  // The events are opened as a group, so that they are counted over the same time and read together.
+  for (const auto config : {PERF_COUNT_HW_INSTRUCTIONS, PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_CACHE_MISSES,
+                            PERF_COUNT_HW_BRANCH_MISSES}) {
+    perf_event_attr attributes{};
+    attributes.type = PERF_TYPE_HARDWARE;
+    attributes.size = sizeof(attributes);
+    attributes.config = config;
+    attributes.read_format = PERF_FORMAT_GROUP;
+    attributes.disabled = descriptors.empty() ? 1 : 0;
+    attributes.inherit = 1;
+    // Counting only user space is allowed to unprivileged processes by the default paranoia level.
+    attributes.exclude_kernel = 1;
+    attributes.exclude_hv = 1;
+    const auto groupDescriptor = descriptors.empty() ? -1 : descriptors.front();
+    const auto descriptor = static_cast<int>(syscall(SYS_perf_event_open, &attributes, 0, -1, groupDescriptor, 0));
+    if (descriptor < 0) {
+      for (const auto openedDescriptor : descriptors) {
+        close(openedDescriptor);
+      }
+      descriptors.clear();
+      return;
+    }
+    descriptors.push_back(descriptor);
+  }
+  ioctl(descriptors.front(), PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+  ioctl(descriptors.front(), PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+#endif
+}
+
+PerformanceCounters::~PerformanceCounters() {
+  for (const auto descriptor : descriptors) {
+    close(descriptor);
+  }
+}
+
+std::optional<HardwareCounts> PerformanceCounters::read() const {
+  if (descriptors.empty()) {
+    return std::nullopt;
+  }
+  // The number of events is followed by their values in the order in which they were opened.
+  std::array<U64, 5> values{};
+  if (::read(descriptors.front(), values.data(), sizeof(values)) != static_cast<ssize_t>(sizeof(values))) {
+    return std::nullopt;
+  }
+  HardwareCounts counts;
+  counts.instructions = values[1];
+  counts.cycles = values[2];
+  counts.cacheMisses = values[3];
+  counts.branchMisses = values[4];
+  return counts;
+}
 } // namespace WayoutPlayer
@@ -1,7 +1,16 @@
 #pragma once
 
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
 #include <string>
+#include <thread>
+#include <optional>
+#include <utility>
+#include <vector>
 
+#include "Solution.hpp"
 #include "Types.hpp"
 
 #ifdef __linux__
@@ -18,5 +27,78 @@ public:
   [[nodiscard]] U64 getMaximumResidentSetSizeInBytes() const;
 
   [[nodiscard]] std::string getMaximumResidentSetSizeAsHumanReadableString() const;
+
+  /**
+   * Returns how many bytes of memory the process has resident right now, or zero if this is not known.
+   */
+  static U64 getCurrentResidentSetSizeInBytes();
+
+  /**
+   * Returns how many minor and major page faults the process has taken so far.
+   */
+  static std::pair<U64, U64> getPageFaults();
+};
+
+/**
+ * Samples the resident set size of the process on a background thread while it exists.
+ *
+ * Unlike the maximum resident set size, which only grows, the peak measured by a sampler belongs to the time it ran.
+ */
+class ResourceSampler {
+  std::atomic<U64> peakResidentSetSize = 0;
+  U64 initialMinorPageFaults = 0;
+  U64 initialMajorPageFaults = 0;
+  std::mutex mutex;
+  std::condition_variable stopped;
+  bool stopping = false;
+  std::thread thread;
+
+  void sample();
+
+public:
+  explicit ResourceSampler(std::chrono::milliseconds interval = std::chrono::milliseconds(10));
+
+  ResourceSampler(const ResourceSampler &) = delete;
+
+  ResourceSampler &operator=(const ResourceSampler &) = delete;
+
+  ~ResourceSampler();
+
+  /**
+   * Returns the largest resident set size sampled so far, including a sample taken by this call.
+   */
+  [[nodiscard]] U64 getPeakResidentSetSizeInBytes();
+
+  /**
+   * Returns how many minor page faults the process took since the sampler was created.
+   */
+  [[nodiscard]] U64 getMinorPageFaults() const;
+
+  [[nodiscard]] U64 getMajorPageFaults() const;
+};
+
+/**
+ * Counts instructions, cycles, cache misses and branch misses of the calling thread, and of the threads it starts,
+ * from its creation on.
+ *
+ * Counting uses perf events on Linux. Where they are missing or forbidden nothing is counted, and no error is reported.
+ */
+class PerformanceCounters {
+  // The file descriptors of the events, the first of which leads the group.
+  std::vector<int> descriptors;
+
+public:
+  PerformanceCounters();
+
+  PerformanceCounters(const PerformanceCounters &) = delete;
+
+  PerformanceCounters &operator=(const PerformanceCounters &) = delete;
+
+  ~PerformanceCounters();
+
+  /**
+   * Returns the events counted so far, or nothing if they cannot be counted.
+   */
+  [[nodiscard]] std::optional<HardwareCounts> read() const;
 };
 } // namespace WayoutPlayer
@@ -0,0 +1,76 @@
+#include "ThreadPool.hpp"
+
+#include <algorithm>
+
+namespace WayoutPlayer {
+ThreadPool::ThreadPool(U32 threadCount) {
+  threadCount = std::max(threadCount, 1u);
+  workers.reserve(threadCount);
+  for (U32 i = 0; i < threadCount; i++) {
+    workers.emplace_back(&ThreadPool::work, this);
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    const std::lock_guard<std::mutex> lock(mutex);
+    stopping = true;
+  }
+  taskAvailable.notify_all();
+  for (auto &worker : workers) {
+    worker.join();
+  }
+}
+
+void ThreadPool::work() {
+  while (true) {
+    std::function<void()> task;
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      taskAvailable.wait(lock, [this] { return stopping || !tasks.empty(); });
+      if (tasks.empty()) {
+        return;
+      }
+      task = std::move(tasks.front());
+      tasks.pop();
+    }
+    std::exception_ptr exception;
+    try {
+      task();
+    } catch (...) {
+      exception = std::current_exception();
+    }
+    const std::lock_guard<std::mutex> lock(mutex);
+    if (exception && !firstException) {
+      firstException = exception;
+    }
+    unfinishedTaskCount--;
+    if (unfinishedTaskCount == 0) {
+      tasksFinished.notify_all();
+    }
+  }
+}
+
+U32 ThreadPool::getThreadCount() const {
+  return static_cast<U32>(workers.size());
+}
+
+void ThreadPool::submit(std::function<void()> task) {
+  {
+    const std::lock_guard<std::mutex> lock(mutex);
+    tasks.push(std::move(task));
+    unfinishedTaskCount++;
+  }
+  taskAvailable.notify_one();
+}
+
+void ThreadPool::wait() {
+  std::unique_lock<std::mutex> lock(mutex);
+  tasksFinished.wait(lock, [this] { return unfinishedTaskCount == 0; });
+  if (firstException) {
+    const auto exception = firstException;
+    firstException = nullptr;
+    std::rethrow_exception(exception);
+  }
+}
+} // namespace WayoutPlayer
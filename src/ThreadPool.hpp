@@ -0,0 +1,49 @@
+#pragma once
+
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+#include "Types.hpp"
+
+namespace WayoutPlayer {
+/**
+ * A fixed set of worker threads which run submitted tasks in submission order.
+ *
+ * The first exception thrown by a task is rethrown by wait().
+ */
+class ThreadPool {
+  std::vector<std::thread> workers;
+  std::queue<std::function<void()>> tasks;
+  std::mutex mutex;
+  std::condition_variable taskAvailable;
+  std::condition_variable tasksFinished;
+  U64 unfinishedTaskCount = 0;
+  bool stopping = false;
+  std::exception_ptr firstException;
+
+  void work();
+
+public:
+  explicit ThreadPool(U32 threadCount);
+
+  ThreadPool(const ThreadPool &) = delete;
+
+  ThreadPool &operator=(const ThreadPool &) = delete;
+
+  ~ThreadPool();
+
+  [[nodiscard]] U32 getThreadCount() const;
+
+  void submit(std::function<void()> task);
+
+  /**
+   * Blocks until every submitted task has finished.
+   */
+  void wait();
+};
+} // namespace WayoutPlayer
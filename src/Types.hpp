@@ -3,14 +3,16 @@
 #include <cstdint>
 
 using U8 = uint8_t;
+using U16 = uint16_t;
 using U32 = uint32_t;
 using U64 = uint64_t;
 
 using S8 = int8_t;
+using S16 = int16_t;
 using S32 = int32_t;
 using S64 = int64_t;
 
-using IndexType = S8;
+using IndexType = S16;
 
 using F32 = float;
 using F64 = double;
\ No newline at end of file
@@ -3,9 +3,40 @@
 
 #include <boost/test/unit_test.hpp>
 
+#include <atomic>
+#include <filesystem>
+#include <random>
+#include <set>
+
+#include <unistd.h>
+
+#include "../src/Arena.hpp"
+#include "../src/BeamSearchEngine.hpp"
+#include "../src/BitPlane.hpp"
 #include "../src/Board.hpp"
+#include "../src/BoardGenerator.hpp"
+#include "../src/BoardLayout.hpp"
+#include "../src/BoardReader.hpp"
+#include "../src/ChasingEngine.hpp"
+#include "../src/ComponentCache.hpp"
+#include "../src/Corpus.hpp"
+#include "../src/CorpusIndex.hpp"
+#include "../src/EndgameTable.hpp"
+#include "../src/Filesystem.hpp"
+#include "../src/Frontier.hpp"
 #include "../src/Hashing.hpp"
+#include "../src/HybridEngine.hpp"
+#include "../src/LocalSearchEngine.hpp"
+#include "../src/PackedBoard.hpp"
+#include "../src/PatternDatabase.hpp"
+#include "../src/RevolvingDoor.hpp"
+#include "../src/Session.hpp"
+#include "../src/SolvabilityCheck.hpp"
+#include "../src/SolveScheduler.hpp"
+#include "../src/SolveServer.hpp"
 #include "../src/Solver.hpp"
+#include "../src/SystemInformation.hpp"
+#include "../src/ThreadPool.hpp"
 #include "../src/TileType.hpp"
 
 using namespace WayoutPlayer;
@@ -259,3 +290,1084 @@ BOOST_AUTO_TEST_CASE(splittingComponentsShouldRespectTwins) {
   BOOST_CHECK(components.front() == board);
   BOOST_CHECK(Board::mergeComponents(components) == board);
 }
+
+BOOST_AUTO_TEST_CASE(revolvingDoorShouldVisitEveryCombinationOnceBySwappingOneElement) {
+  for (S32 n = 0; n <= 8; n++) {
+    for (S32 t = 0; t <= n; t++) {
+      const auto combinationCount = binomialCoefficient(n, t);
+      std::set<std::vector<S32>> visited;
+      RevolvingDoorCombination combination(n, t);
+      for (U64 rank = 0; rank < combinationCount; rank++) {
+        const auto elements = combination.getElements();
+        BOOST_CHECK(elements == RevolvingDoorCombination(n, t, rank).getElements());
+        BOOST_CHECK(std::is_sorted(std::begin(elements), std::end(elements)));
+        visited.insert(elements);
+        S32 removed = 0;
+        S32 added = 0;
+        const auto advanced = combination.next(removed, added);
+        BOOST_CHECK(advanced == (rank + 1 < combinationCount));
+        if (advanced) {
+          BOOST_CHECK(std::count(std::begin(elements), std::end(elements), removed) == 1);
+          BOOST_CHECK(std::count(std::begin(elements), std::end(elements), added) == 0);
+        }
+      }
+      BOOST_CHECK(visited.size() == combinationCount);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(subsetEnumerationShouldAgreeWithBreadthFirstSearch) {
+  const auto boardString = "D1 D0 D1 D0\n"
+                           "D0 H1 C1 D0\n"
+                           "V1 D0 T1 D1\n"
+                           "D1 P1 D0 P1";
+  const auto board = Board::fromString(boardString);
+  auto breadthFirstSolver = Solver();
+  breadthFirstSolver.getSolverConfiguration().setEngine(SolverEngine::BreadthFirst);
+  const auto expectedClickCount = breadthFirstSolver.findSolution(board).getClicks().size();
+  for (const U32 threadCount : {1u, 4u}) {
+    auto solver = Solver();
+    solver.getSolverConfiguration().setEngine(SolverEngine::SubsetEnumeration);
+    solver.getSolverConfiguration().setThreadCount(threadCount);
+    const auto solution = solver.findSolution(board);
+    BOOST_CHECK(solution.isOptimal());
+    BOOST_CHECK(solution.getClicks().size() == expectedClickCount);
+    auto solvedBoard = board;
+    for (const auto click : solution.getClicks()) {
+      solvedBoard.activate(click.i, click.j);
+    }
+    BOOST_CHECK(solvedBoard.isSolved());
+  }
+}
+
+BOOST_AUTO_TEST_CASE(canonicalClickOrderShouldNotDependOnDeduplication) {
+  const auto boardString = "C1 C1 D1 D1\n"
+                           "D0 D0 D1 D1\n"
+                           "D1 D0 C1 D1";
+  const auto board = Board::fromString(boardString);
+  std::vector<std::size_t> clickCounts;
+  for (const auto deduplicating : {false, true}) {
+    auto solver = Solver();
+    solver.getSolverConfiguration().setEngine(SolverEngine::BreadthFirst);
+    solver.getSolverConfiguration().setDeduplicateCommutativeBoards(deduplicating);
+    const auto solution = solver.findSolution(board);
+    auto solvedBoard = board;
+    for (const auto click : solution.getClicks()) {
+      solvedBoard.activate(click.i, click.j);
+    }
+    BOOST_CHECK(solvedBoard.isSolved());
+    clickCounts.push_back(solution.getClicks().size());
+  }
+  BOOST_CHECK(clickCounts.front() == clickCounts.back());
+  BOOST_CHECK(clickCounts.front() <= 4);
+}
+
+BOOST_AUTO_TEST_CASE(boardReaderShouldSplitStreamsOfBoards) {
+  const auto stream = "# First\n"
+                      "D0 D1\n"
+                      "D1 D1\n"
+                      "\n"
+                      "\n"
+                      "   D1\n"
+                      "D1 T1\n"
+                      "# Third\n"
+                      "B1\n";
+  BoardReader boardReader(stream);
+  const auto first = boardReader.next();
+  BOOST_REQUIRE(first);
+  BOOST_CHECK(first->name == "First");
+  BOOST_CHECK(first->board.toString() == "D0 D1\nD1 D1");
+  const auto second = boardReader.next();
+  BOOST_REQUIRE(second);
+  BOOST_CHECK(second->name.empty());
+  BOOST_CHECK(second->board.toString() == "   D1\nD1 T1");
+  const auto third = boardReader.next();
+  BOOST_REQUIRE(third);
+  BOOST_CHECK(third->name == "Third");
+  BOOST_CHECK(third->board.toString() == "B1");
+  BOOST_CHECK(!boardReader.next());
+}
+
+BOOST_AUTO_TEST_CASE(boardParsingShouldRejectNonRectangularBoards) {
+  BOOST_CHECK_THROW(Board::fromString("D0 D0\nD0"), std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_CASE(hashingShouldProduceFullDigests) {
+  const auto digest = computeDigest("");
+  BOOST_CHECK(digestToHexadecimal(digest).starts_with("cf83e1357eefb8bd"));
+  BOOST_CHECK(digestFromHexadecimal(digestToHexadecimal(digest)) == digest);
+}
+
+BOOST_AUTO_TEST_CASE(solutionsShouldBeReadFromTheirStrings) {
+  const auto solution = Solution({Position{0, 1}, Position{2, 3}}, true);
+  const auto playerOutput = "B1 D0\nFound 1 component.\n" + solution.toString() + "\nExplored nodes: 2";
+  BOOST_CHECK(Solution::fromString(playerOutput) == solution);
+  const auto emptySolution = Solution({}, false);
+  BOOST_CHECK(Solution::fromString(emptySolution.toString()) == emptySolution);
+}
+
+BOOST_AUTO_TEST_CASE(corpusShouldRoundTripBoardsAndSolutions) {
+  const std::vector<std::string> boardStrings = {"D0 D1 D0\nD1 D1 D1\nD0 D1 D0", "B1 D0\nD0 B1", "   P1 C0\nT1 H0 V1"};
+  std::vector<CorpusEntry> entries;
+  for (const auto &boardString : boardStrings) {
+    entries.push_back(CorpusEntry{computeDigest(boardString), Board::fromString(boardString), std::nullopt});
+  }
+  entries[1].solution = Solution({Position{0, 1}, Position{0, 1}}, true);
+  const auto bytes = Corpus::serialize(entries);
+  BOOST_REQUIRE(Corpus::isCorpus(bytes));
+  const Corpus corpus(bytes);
+  BOOST_CHECK(corpus.getEntryCount() == boardStrings.size());
+  for (const auto &entry : entries) {
+    const auto found = corpus.find(entry.digest);
+    BOOST_REQUIRE(found);
+    BOOST_CHECK(found->board == entry.board);
+    BOOST_CHECK(found->solution == entry.solution);
+  }
+  BOOST_CHECK(!corpus.find(computeDigest("D1")));
+}
+
+BOOST_AUTO_TEST_CASE(packedBoardsShouldBehaveAsBoards) {
+  std::mt19937 generator(2020);
+  const std::string tileCharacters = "DHVTBCP ";
+  for (auto trial = 0; trial < 200; trial++) {
+    std::string boardString;
+    for (auto i = 0; i < 5; i++) {
+      for (auto j = 0; j < 5; j++) {
+        const auto character = tileCharacters[generator() % tileCharacters.size()];
+        boardString += character;
+        boardString += character == ' ' ? ' ' : static_cast<char>('0' + generator() % 2);
+        boardString += j + 1 < 5 ? " " : "";
+      }
+      boardString += i + 1 < 5 ? "\n" : "";
+    }
+    auto board = Board::fromString(boardString);
+    const BoardLayout layout(board);
+    PackedBoard packedBoard(layout, board);
+    for (auto click = 0; click < 10 && layout.getTileCount() > 0; click++) {
+      const auto index = static_cast<S32>(generator() % layout.getTileCount());
+      if (packedBoard.getType(layout, index) == TileType::Blocked) {
+        continue;
+      }
+      const auto position = layout.getPosition(index);
+      board.activate(position.i, position.j);
+      packedBoard.activate(layout, index);
+      BOOST_REQUIRE(packedBoard == PackedBoard(layout, board));
+      BOOST_REQUIRE(packedBoard.isSolved() == board.isSolved());
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(breadthFirstSearchShouldReportArenaMemory) {
+  auto solver = Solver();
+  solver.getSolverConfiguration().setEngine(SolverEngine::BreadthFirst);
+  const auto solution = solver.findSolution(Board::fromString("B1 D0\nD0 B1"));
+  BOOST_REQUIRE(solution.getArenaUsedBytes());
+  BOOST_REQUIRE(solution.getArenaReservedBytes());
+  BOOST_CHECK(*solution.getArenaUsedBytes() > 0);
+  BOOST_CHECK(*solution.getArenaUsedBytes() <= *solution.getArenaReservedBytes());
+}
+
+BOOST_AUTO_TEST_CASE(hugePageResourcesShouldServeLargeAndSmallChunks) {
+  for (const auto hugePages : HugePagesValues) {
+    BOOST_CHECK(hugePagesFromString(hugePagesToString(hugePages)) == hugePages);
+    auto *resource = getSearchResource(hugePages);
+    for (const auto bytes : {std::size_t{64}, 3 * HugePageMemoryResource::HugePageSize + 1}) {
+      auto *pointer = static_cast<char *>(resource->allocate(bytes, alignof(std::max_align_t)));
+      pointer[0] = 1;
+      pointer[bytes - 1] = 1;
+      resource->deallocate(pointer, bytes, alignof(std::max_align_t));
+    }
+  }
+  BOOST_CHECK_THROW(hugePagesFromString("always"), std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_CASE(breadthFirstSearchShouldNotDependOnHugePages) {
+  auto board = Board::fromString("D0 D0 D0 D0\nD0 D0 D0 D0\nD0 D0 D0 D0\nD0 D0 D0 D0");
+  for (const auto &[i, j] : {std::pair{0, 1}, std::pair{1, 3}, std::pair{2, 0}, std::pair{3, 2}, std::pair{2, 2}}) {
+    board.activate(i, j);
+  }
+  auto solver = Solver();
+  solver.getSolverConfiguration().setEngine(SolverEngine::BreadthFirst);
+  const auto expected = solver.findSolution(board);
+  for (const auto hugePages : HugePagesValues) {
+    solver.getSolverConfiguration().setHugePages(hugePages);
+    const auto solution = solver.findSolution(board);
+    BOOST_CHECK(solution.getClicks() == expected.getClicks());
+  }
+}
+
+BOOST_AUTO_TEST_CASE(frontierShouldBeFirstInFirstOutAcrossBlocks) {
+  Arena arena;
+  Frontier frontier(arena.getResource());
+  U32 pushed = 0;
+  U32 popped = 0;
+  // Interleave pushes and pops so that the front and the back wrap around several blocks.
+  for (S32 round = 0; round < 8; round++) {
+    for (std::size_t i = 0; i < Frontier::BlockSize + 3; i++) {
+      SearchState state;
+      state.pathNode = pushed++;
+      frontier.push(state);
+    }
+    for (std::size_t i = 0; i < Frontier::BlockSize - 1; i++) {
+      BOOST_CHECK_EQUAL(frontier.front().pathNode, popped++);
+      frontier.pop();
+    }
+  }
+  BOOST_CHECK_EQUAL(frontier.getSize(), pushed - popped);
+  while (!frontier.isEmpty()) {
+    BOOST_CHECK_EQUAL(frontier.front().pathNode, popped++);
+    frontier.pop();
+  }
+  BOOST_CHECK_EQUAL(popped, pushed);
+}
+
+BOOST_AUTO_TEST_CASE(layeredFrontierShouldReturnEveryStateOfALayerBeforeTheNext) {
+  Arena arena;
+  LayeredFrontier frontier(arena.getResource());
+  std::mt19937_64 generator(41);
+  const auto getKey = [](const SearchState &state) {
+    return state.board.up ^ state.board.blocked ^ state.clicked ^ state.pathNode ^
+           static_cast<U64>(state.firstClickableIndex);
+  };
+  std::vector<std::vector<U64>> pushedKeys(3);
+  const auto pushLayer = [&](std::size_t layer) {
+    const auto stateCount = LayeredFrontier::BlockSize + 1000 * layer + 1;
+    for (std::size_t i = 0; i < stateCount; i++) {
+      SearchState state;
+      state.board.up = generator() >> (generator() % 64);
+      state.board.blocked = generator() % 4 == 0 ? generator() : 0;
+      state.clicked = generator();
+      state.pathNode = static_cast<U32>(generator());
+      state.firstClickableIndex = static_cast<S32>(generator() % 65);
+      frontier.push(state);
+      pushedKeys[layer].push_back(getKey(state));
+    }
+    std::sort(std::begin(pushedKeys[layer]), std::end(pushedKeys[layer]));
+  };
+  pushLayer(0);
+  frontier.advanceLayer();
+  BOOST_CHECK_EQUAL(frontier.getSize(), pushedKeys[0].size());
+  // As in breadth-first search, every layer is pushed while the one before it is being popped.
+  for (std::size_t layer = 0; layer < pushedKeys.size(); layer++) {
+    std::vector<U64> poppedKeys;
+    std::pmr::vector<SearchState> states;
+    while (frontier.popBlock(states)) {
+      if (poppedKeys.empty() && layer + 1 < pushedKeys.size()) {
+        pushLayer(layer + 1);
+      }
+      for (const auto &state : states) {
+        poppedKeys.push_back(getKey(state));
+      }
+    }
+    std::sort(std::begin(poppedKeys), std::end(poppedKeys));
+    BOOST_CHECK(poppedKeys == pushedKeys[layer]);
+    frontier.advanceLayer();
+    const auto nextSize = layer + 1 < pushedKeys.size() ? pushedKeys[layer + 1].size() : 0;
+    BOOST_CHECK_EQUAL(frontier.getSize(), nextSize);
+  }
+  BOOST_CHECK(frontier.isEmpty());
+  const auto board = Board::fromString("D1 D0 D1 D0\n"
+                                       "D0 D1 D1 D0\n"
+                                       "D1 D0 D0 D1");
+  auto solver = Solver();
+  solver.getSolverConfiguration().setEngine(SolverEngine::BreadthFirst);
+  const auto compressedSolution = solver.findSolution(board);
+  solver.getSolverConfiguration().setCompressFrontier(false);
+  BOOST_CHECK_EQUAL(compressedSolution.getClicks().size(), solver.findSolution(board).getClicks().size());
+}
+
+BOOST_AUTO_TEST_CASE(threadPoolShouldRunEveryTaskAndRethrowFailures) {
+  ThreadPool threadPool(4);
+  std::atomic<U32> sum = 0;
+  for (U32 i = 1; i <= 100; i++) {
+    threadPool.submit([&sum, i] { sum += i; });
+  }
+  threadPool.wait();
+  BOOST_CHECK_EQUAL(sum.load(), 5050u);
+  threadPool.submit([] { throw std::runtime_error("Failed."); });
+  BOOST_CHECK_THROW(threadPool.wait(), std::runtime_error);
+  threadPool.submit([&sum] { sum = 0; });
+  threadPool.wait();
+  BOOST_CHECK_EQUAL(sum.load(), 0u);
+}
+
+BOOST_AUTO_TEST_CASE(corpusIndexShouldOnlyHashChangedFiles) {
+  const auto directory = std::filesystem::temp_directory_path() / "wayout-player-corpus-index-test";
+  std::filesystem::remove_all(directory);
+  std::filesystem::create_directories(directory);
+  writeFile((directory / "a.txt").string(), "D1\n");
+  writeFile((directory / "b.txt").string(), "D1\n");
+  writeFile((directory / "c.txt").string(), "D0\n");
+  writeFile((directory / "ignored.md").string(), "D0\n");
+  CorpusIndex index;
+  BOOST_CHECK_EQUAL(index.update(directory.string(), 2), 3u);
+  BOOST_CHECK(index.find(computeDigest("D1\n")) == std::vector<std::string>({"a.txt", "b.txt"}));
+  BOOST_CHECK(index.findDuplicates() == std::vector<std::vector<std::string>>({{"a.txt", "b.txt"}}));
+  index = CorpusIndex::fromString(index.toString());
+  BOOST_CHECK_EQUAL(index.update(directory.string(), 2), 0u);
+  writeFile((directory / "c.txt").string(), "D1 D0\n");
+  BOOST_CHECK_EQUAL(index.update(directory.string(), 2), 1u);
+  BOOST_CHECK(index.find(computeDigest("D1 D0\n")) == std::vector<std::string>({"c.txt"}));
+  BOOST_CHECK(index.find(computeDigest("D0\n")).empty());
+  std::filesystem::remove_all(directory);
+}
+
+BOOST_AUTO_TEST_CASE(solveServerShouldAnswerRequestsInOrder) {
+  std::array<int, 2> requestPipe{};
+  std::array<int, 2> responsePipe{};
+  BOOST_REQUIRE(pipe(requestPipe.data()) == 0);
+  BOOST_REQUIRE(pipe(responsePipe.data()) == 0);
+  const std::string requests = "# first\nD1 D1 D1\nD0 D1 D0\n\n# second\nD1 X\n\n# third\nD0\n";
+  BOOST_REQUIRE(write(requestPipe[1], requests.data(), requests.size()) == static_cast<ssize_t>(requests.size()));
+  close(requestPipe[1]);
+  const Solver solver;
+  SolveServer server(solver, 2);
+  server.serve(requestPipe[0], responsePipe[1]);
+  close(requestPipe[0]);
+  close(responsePipe[1]);
+  std::string responses;
+  std::array<char, 4096> buffer{};
+  for (auto bytesRead = read(responsePipe[0], buffer.data(), buffer.size()); bytesRead > 0;
+       bytesRead = read(responsePipe[0], buffer.data(), buffer.size())) {
+    responses.append(buffer.data(), static_cast<std::size_t>(bytesRead));
+  }
+  close(responsePipe[0]);
+  const auto first = responses.find("# first\nFound an optimal solution with 1 click:\n  (0, 1)\n");
+  const auto second = responses.find("# second\nThrew an exception.\n");
+  const auto third = responses.find("# third\nFound an optimal solution with 0 clicks:\n");
+  BOOST_CHECK(first == 0);
+  BOOST_CHECK(second != std::string::npos && first < second);
+  BOOST_CHECK(third != std::string::npos && second < third);
+  BOOST_CHECK(responses.ends_with("\n\n"));
+}
+
+BOOST_AUTO_TEST_CASE(iterativeDeepeningShouldAgreeWithBreadthFirstSearch) {
+  std::mt19937 generator(2034);
+  const std::string tileCharacters = "DDDHVTBCP";
+  for (auto trial = 0; trial < 100; trial++) {
+    std::string boardString;
+    for (auto i = 0; i < 3; i++) {
+      for (auto j = 0; j < 3; j++) {
+        boardString += tileCharacters[generator() % tileCharacters.size()];
+        boardString += "0";
+        boardString += j + 1 < 3 ? " " : "";
+      }
+      boardString += i + 1 < 3 ? "\n" : "";
+    }
+    auto board = Board::fromString(boardString);
+    for (auto click = 0; click < 3; click++) {
+      const auto i = static_cast<S32>(generator() % 3);
+      const auto j = static_cast<S32>(generator() % 3);
+      if (board.getTile(i, j).type != TileType::Blocked) {
+        board.activate(i, j);
+      }
+    }
+    auto solver = Solver();
+    solver.getSolverConfiguration().setEngine(SolverEngine::BreadthFirst);
+    std::optional<Solution> expected;
+    try {
+      expected = solver.findSolution(board);
+    } catch (const std::runtime_error &) {
+      continue;
+    }
+    solver.getSolverConfiguration().setEngine(SolverEngine::IterativeDeepening);
+    for (const auto threadCount : {1u, 3u}) {
+      for (const auto transpositionTableSize : {0u, 1u << 10u}) {
+        solver.getSolverConfiguration().setThreadCount(threadCount);
+        solver.getSolverConfiguration().setTranspositionTableSize(transpositionTableSize);
+        const auto solution = solver.findSolution(board);
+        BOOST_REQUIRE_EQUAL(solution.getClicks().size(), expected->getClicks().size());
+        BOOST_CHECK(solution.isOptimal());
+        auto solvedBoard = board;
+        for (const auto &position : solution.getClicks()) {
+          solvedBoard.activate(position.i, position.j);
+        }
+        BOOST_CHECK(solvedBoard.isSolved());
+      }
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(optimalSearchesShouldClickTwinsAgain) {
+  // Clicking the top left twin twice sets the twins and flips nothing else.
+  const auto boardString = "P0 D0 D0\n"
+                           "D0    D0\n"
+                           "P1 D0 P1";
+  const auto board = Board::fromString(boardString);
+  auto solver = Solver();
+  for (const auto engine : {SolverEngine::BreadthFirst, SolverEngine::IterativeDeepening, SolverEngine::Hybrid}) {
+    solver.getSolverConfiguration().setEngine(engine);
+    const auto solution = solver.findSolution(board);
+    BOOST_CHECK_EQUAL(solution.getClicks().size(), 2u);
+    auto solvedBoard = board;
+    for (const auto &position : solution.getClicks()) {
+      solvedBoard.activate(position.i, position.j);
+    }
+    BOOST_CHECK(solvedBoard.isSolved());
+  }
+}
+
+BOOST_AUTO_TEST_CASE(patternDatabasesShouldNeverOverestimate) {
+  std::mt19937 generator(2035);
+  const std::string tileCharacters = "DDDDHVB";
+  const auto directory = std::filesystem::temp_directory_path() / "wayout-player-pattern-database-test";
+  std::filesystem::remove_all(directory);
+  for (auto trial = 0; trial < 20; trial++) {
+    std::string boardString;
+    for (auto i = 0; i < 3; i++) {
+      for (auto j = 0; j < 5; j++) {
+        boardString += tileCharacters[generator() % tileCharacters.size()];
+        boardString += static_cast<char>('0' + generator() % 2);
+        boardString += j + 1 < 5 ? " " : "";
+      }
+      boardString += i + 1 < 3 ? "\n" : "";
+    }
+    const auto board = Board::fromString(boardString);
+    const BoardLayout layout(board);
+    const auto patternDatabase = PatternDatabase::build(layout);
+    BOOST_CHECK_EQUAL(patternDatabase.getRegionCount(), 2u);
+    const auto estimate = patternDatabase.estimateClicks(PackedBoard(layout, board));
+    auto solver = Solver();
+    solver.getSolverConfiguration().setEngine(SolverEngine::BreadthFirst);
+    try {
+      const auto clickCount = static_cast<S32>(solver.findSolution(board).getClicks().size());
+      BOOST_CHECK(estimate != PatternDatabase::Unsolvable);
+      BOOST_CHECK(estimate <= clickCount);
+    } catch (const std::runtime_error &) {
+    }
+    const auto cached = PatternDatabase::loadOrBuild(layout, directory.string());
+    const auto reloaded = PatternDatabase::loadOrBuild(layout, directory.string());
+    BOOST_CHECK(cached.serialize() == patternDatabase.serialize());
+    BOOST_CHECK(reloaded.serialize() == patternDatabase.serialize());
+    BOOST_CHECK_EQUAL(reloaded.estimateClicks(PackedBoard(layout, board)), estimate);
+  }
+  std::filesystem::remove_all(directory);
+}
+
+BOOST_AUTO_TEST_CASE(localSearchShouldFindShortSolutions) {
+  std::mt19937 generator(2036);
+  const std::string tileCharacters = "DDDHVTB";
+  for (auto trial = 0; trial < 40; trial++) {
+    std::string boardString;
+    for (auto i = 0; i < 3; i++) {
+      for (auto j = 0; j < 4; j++) {
+        boardString += tileCharacters[generator() % tileCharacters.size()];
+        boardString += "0";
+        boardString += j + 1 < 4 ? " " : "";
+      }
+      boardString += i + 1 < 3 ? "\n" : "";
+    }
+    auto board = Board::fromString(boardString);
+    for (auto click = 0; click < 4; click++) {
+      const auto i = static_cast<S32>(generator() % 3);
+      const auto j = static_cast<S32>(generator() % 4);
+      if (board.getTile(i, j).type != TileType::Blocked) {
+        board.activate(i, j);
+      }
+    }
+    auto solver = Solver();
+    solver.getSolverConfiguration().setEngine(SolverEngine::BreadthFirst);
+    std::optional<Solution> expected;
+    try {
+      expected = solver.findSolution(board);
+    } catch (const std::runtime_error &) {
+      continue;
+    }
+    solver.getSolverConfiguration().setEngine(SolverEngine::LocalSearch);
+    solver.getSolverConfiguration().setLocalSearchTimeBudget(std::chrono::milliseconds(20));
+    const auto solution = solver.findSolution(board);
+    BOOST_CHECK(solution.getClicks().size() >= expected->getClicks().size());
+    if (board.hasCommutativeClicks()) {
+      BOOST_CHECK(solution.isOptimal());
+      BOOST_CHECK_EQUAL(solution.getClicks().size(), expected->getClicks().size());
+    }
+    auto solvedBoard = board;
+    for (const auto &position : solution.getClicks()) {
+      solvedBoard.activate(position.i, position.j);
+    }
+    BOOST_CHECK(solvedBoard.isSolved());
+  }
+}
+
+BOOST_AUTO_TEST_CASE(localSearchShouldStopWhenItsTimeBudgetRunsOut) {
+  // The blocked tile makes clicks depend on their order, so the first solution comes from the greedy search.
+  const auto board = Board::fromString("D1 B0 D1\nD0 D1 D0");
+  BOOST_REQUIRE(!board.hasCommutativeClicks());
+  SolverConfiguration configuration;
+  configuration.setLocalSearchTimeBudget(std::chrono::milliseconds(0));
+  BOOST_CHECK_THROW(static_cast<void>(LocalSearchEngine(configuration).findSolution(board)), std::runtime_error);
+  configuration.setLocalSearchTimeBudget(std::chrono::milliseconds(100));
+  const auto solution = LocalSearchEngine(configuration).findSolution(board);
+  auto solvedBoard = board;
+  for (const auto &position : solution.getClicks()) {
+    solvedBoard.activate(position.i, position.j);
+  }
+  BOOST_CHECK(solvedBoard.isSolved());
+}
+
+BOOST_AUTO_TEST_CASE(localSearchShouldRemoveRedundantClicksFromLargeSolutionSpaces) {
+  // Both tiles of every pair have the same effect, so the board has 2^24 solutions.
+  std::mt19937 generator(36);
+  std::string boardString;
+  auto raisedPairCount = 0u;
+  for (auto i = 0; i < 8; i++) {
+    for (auto pair = 0; pair < 3; pair++) {
+      const auto up = generator() % 2 == 0;
+      raisedPairCount += up ? 1 : 0;
+      boardString += up ? "H1 H1" : "H0 H0";
+      boardString += pair + 1 < 3 ? "    " : "";
+    }
+    boardString += i + 1 < 8 ? "\n" : "";
+  }
+  const auto board = Board::fromString(boardString);
+  SolverConfiguration configuration;
+  configuration.setLocalSearchTimeBudget(std::chrono::milliseconds(20));
+  const auto solution = LocalSearchEngine(configuration).findSolution(board);
+  BOOST_CHECK(!solution.isOptimal());
+  BOOST_CHECK_EQUAL(solution.getClicks().size(), raisedPairCount);
+  auto solvedBoard = board;
+  for (const auto &position : solution.getClicks()) {
+    solvedBoard.activate(position.i, position.j);
+  }
+  BOOST_CHECK(solvedBoard.isSolved());
+}
+
+BOOST_AUTO_TEST_CASE(generatedBoardsShouldBeSolvedByTheirClicksAndDependOnlyOnTheSeed) {
+  for (const auto &typeMix : {"D", "DHVT", "DDDB", "DDDC", "DDDP", "DHVTBCP"}) {
+    BoardSpecification specification;
+    specification.rowCount = 4;
+    specification.columnCount = 5;
+    specification.density = 0.8;
+    specification.typeMix = typeMix;
+    specification.clickCount = 6;
+    BoardGenerator generator(37);
+    BoardGenerator sameGenerator(37);
+    for (auto trial = 0; trial < 20; trial++) {
+      const auto generatedBoard = generator.generate(specification);
+      BOOST_CHECK(generatedBoard.board == sameGenerator.generate(specification).board);
+      auto solvedBoard = generatedBoard.board;
+      for (const auto &position : generatedBoard.clicks) {
+        solvedBoard.activate(position.i, position.j);
+      }
+      BOOST_CHECK(solvedBoard.isSolved());
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(limitingRepeatedClicksShouldKeepSolutionsOptimal) {
+  BoardSpecification specification;
+  specification.rowCount = 3;
+  specification.columnCount = 4;
+  specification.typeMix = "DDDHVCBB";
+  specification.clickCount = 5;
+  BoardGenerator generator(39);
+  for (auto trial = 0; trial < 30; trial++) {
+    const auto board = generator.generate(specification).board;
+    // A breadth-first search which may click any tile any number of times.
+    std::set<std::string> seenBoards{board.toString()};
+    std::vector<Board> layer{board};
+    std::size_t expectedClickCount = 0;
+    while (!std::any_of(std::begin(layer), std::end(layer), [](const Board &b) { return b.isSolved(); })) {
+      std::vector<Board> nextLayer;
+      for (const auto &current : layer) {
+        for (S32 i = 0; i < current.getRowCount(); i++) {
+          for (S32 j = 0; j < current.getColumnCount(); j++) {
+            if (current.hasTile(i, j) && current.getTile(i, j).type != TileType::Blocked) {
+              auto derivedBoard = current;
+              derivedBoard.activate(i, j);
+              if (seenBoards.insert(derivedBoard.toString()).second) {
+                nextLayer.push_back(derivedBoard);
+              }
+            }
+          }
+        }
+      }
+      layer = std::move(nextLayer);
+      expectedClickCount++;
+    }
+    for (const auto engine : {SolverEngine::BreadthFirst, SolverEngine::IterativeDeepening}) {
+      auto solver = Solver();
+      solver.getSolverConfiguration().setEngine(engine);
+      BOOST_CHECK_EQUAL(solver.findSolution(board).getClicks().size(), expectedClickCount);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(hybridEngineShouldAgreeWithBreadthFirstSearch) {
+  BoardSpecification specification;
+  specification.rowCount = 3;
+  specification.columnCount = 4;
+  specification.clickCount = 5;
+  BoardGenerator generator(40);
+  for (const auto &typeMix : {"DDDHVT", "DDDDDC", "DDDDDB", "DDDDDP", "DDHVTBCP"}) {
+    specification.typeMix = typeMix;
+    for (auto trial = 0; trial < 20; trial++) {
+      const auto board = generator.generate(specification).board;
+      auto solver = Solver();
+      if (!HybridEngine(solver.getSolverConfiguration()).canSolve(board)) {
+        continue;
+      }
+      solver.getSolverConfiguration().setEngine(SolverEngine::BreadthFirst);
+      const auto expected = solver.findSolution(board);
+      solver.getSolverConfiguration().setEngine(SolverEngine::Hybrid);
+      const auto solution = solver.findSolution(board);
+      BOOST_REQUIRE_EQUAL(solution.getClicks().size(), expected.getClicks().size());
+      BOOST_CHECK(solution.isOptimal());
+      auto solvedBoard = board;
+      for (const auto &position : solution.getClicks()) {
+        solvedBoard.activate(position.i, position.j);
+      }
+      BOOST_CHECK(solvedBoard.isSolved());
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(solutionsShouldBreakMemoryDownByComponent) {
+  const auto board = Board::fromString("D1 D1    D1\n"
+                                       "D1 D0    D1\n"
+                                       "D0 D0    D0");
+  auto solver = Solver();
+  solver.getSolverConfiguration().setEngine(SolverEngine::BreadthFirst);
+  solver.getSolverConfiguration().setSampleResources(true);
+  const auto solution = solver.findSolution(board);
+  BOOST_REQUIRE_EQUAL(solution.getMemoryBreakdowns().size(), 2u);
+  for (const auto &memoryBreakdown : solution.getMemoryBreakdowns()) {
+    BOOST_CHECK(memoryBreakdown.frontierBytes.value_or(0) > 0);
+    BOOST_CHECK(memoryBreakdown.seenBoardBytes.value_or(0) > 0);
+    BOOST_CHECK(memoryBreakdown.pathBytes.value_or(0) > 0);
+    BOOST_CHECK(memoryBreakdown.residentSetSizeBytes.value_or(0) > 0);
+  }
+  const auto statistics = solution.getStatisticsString();
+  BOOST_CHECK(statistics.find("Peak memory of component 2: ") != std::string::npos);
+}
+
+BOOST_AUTO_TEST_CASE(solvesShouldReportProgressUntilTheirSolution) {
+  BoardSpecification specification;
+  specification.rowCount = 4;
+  specification.columnCount = 4;
+  specification.clickCount = 6;
+  const auto board = BoardGenerator(42).generate(specification).board;
+  auto solver = Solver();
+  solver.getSolverConfiguration().setEngine(SolverEngine::BreadthFirst);
+  solver.getSolverConfiguration().setProgressInterval(16);
+  const auto expected = solver.findSolution(board);
+  auto task = solver.solve(board);
+  U32 progressCount = 0;
+  SolveProgress lastProgress;
+  while (task.resume()) {
+    const auto &progress = task.getProgress();
+    BOOST_CHECK_GE(progress.depth, lastProgress.depth);
+    BOOST_CHECK_GT(progress.exploredNodes, lastProgress.exploredNodes);
+    lastProgress = progress;
+    progressCount++;
+  }
+  BOOST_CHECK_GT(progressCount, 1u);
+  BOOST_CHECK_EQUAL(task.getSolution().getClicks().size(), expected.getClicks().size());
+  auto cancelledTask = solver.solve(board);
+  BOOST_REQUIRE(cancelledTask.resume());
+  cancelledTask.cancel();
+  BOOST_CHECK(cancelledTask.isDone());
+  BOOST_CHECK(!cancelledTask.resume());
+  BOOST_CHECK_THROW(static_cast<void>(cancelledTask.getSolution()), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(solveSchedulerShouldCancelSolvesPastTheirDeadline) {
+  auto solver = Solver();
+  solver.getSolverConfiguration().setEngine(SolverEngine::BreadthFirst);
+  solver.getSolverConfiguration().setProgressInterval(4);
+  SolveScheduler scheduler(solver);
+  const auto now = SolveScheduler::Clock::now();
+  const auto lateId = scheduler.add(Board::fromString("D1 D0\nD0 D0"), now + std::chrono::hours(2));
+  const auto expiredId = scheduler.add(Board::fromString("D1 D1\nD0 D0"), now - std::chrono::seconds(1));
+  const auto urgentId = scheduler.add(Board::fromString("D1 D1\nD1 D0"), now + std::chrono::hours(1));
+  const auto cancelledId = scheduler.add(Board::fromString("D1 D1\nD1 D1"), now + std::chrono::hours(1));
+  scheduler.cancel(cancelledId);
+  std::vector<SolveOutcome> outcomes;
+  while (!scheduler.isEmpty()) {
+    if (auto outcome = scheduler.step()) {
+      outcomes.push_back(*outcome);
+    }
+  }
+  BOOST_REQUIRE_EQUAL(outcomes.size(), 3u);
+  BOOST_CHECK_EQUAL(outcomes[0].id, expiredId);
+  BOOST_CHECK(!outcomes[0].solution);
+  BOOST_CHECK_EQUAL(outcomes[0].error, "The deadline passed.");
+  BOOST_CHECK_EQUAL(outcomes[1].id, urgentId);
+  BOOST_CHECK_EQUAL(outcomes[2].id, lateId);
+  for (const auto index : {1, 2}) {
+    BOOST_REQUIRE(outcomes[index].solution);
+    BOOST_CHECK(outcomes[index].solution->isOptimal());
+  }
+}
+
+BOOST_AUTO_TEST_CASE(componentCacheShouldSolveTranslatedComponentsWithoutSearching) {
+  auto solver = Solver();
+  solver.getSolverConfiguration().setEngine(SolverEngine::BreadthFirst);
+  solver.getSolverConfiguration().setComponentCacheSize(1u << 20u);
+  const auto isSolvedBy = [](Board board, const Solution &solution) {
+    for (const auto &position : solution.getClicks()) {
+      board.activate(position.i, position.j);
+    }
+    return board.isSolved();
+  };
+  // The two square components are the same, so only the first one is searched.
+  const auto board = Board::fromString("D1 D1    D1 D1\n"
+                                       "D1 D0    D1 D0\n"
+                                       "              \n"
+                                       "   H1 V0      ");
+  const auto solution = solver.findSolution(board);
+  BOOST_CHECK(isSolvedBy(board, solution));
+  BOOST_CHECK_EQUAL(solver.getComponentCache().getSize(), 2u);
+  BOOST_REQUIRE_EQUAL(solution.getMemoryBreakdowns().size(), 3u);
+  const auto translatedBoard = Board::fromString("        \n"
+                                                 "   H1 V0\n"
+                                                 "        \n"
+                                                 "D1 D1   \n"
+                                                 "D1 D0   ");
+  const auto translatedSolution = solver.findSolution(translatedBoard);
+  BOOST_CHECK(isSolvedBy(translatedBoard, translatedSolution));
+  BOOST_CHECK(translatedSolution.isOptimal());
+  BOOST_CHECK_EQUAL(translatedSolution.getExploredNodes().value_or(1), 0u);
+  BOOST_CHECK_EQUAL(translatedSolution.getClicks().size(), solution.getClicks().size() - 1);
+}
+
+BOOST_AUTO_TEST_CASE(componentCacheShouldForgetTheLeastRecentlyUsedComponents) {
+  const SolverConfiguration configuration;
+  const auto first = NormalizedComponent::fromBoard(Board::fromString("D1 D1"), configuration);
+  const auto second = NormalizedComponent::fromBoard(Board::fromString("D1\nD1"), configuration);
+  const auto third = NormalizedComponent::fromBoard(Board::fromString("   H1"), configuration);
+  BOOST_CHECK(first.key != second.key);
+  ComponentCache cache;
+  cache.insert(first, {Position(0, 0)}, 1u << 20u);
+  cache.insert(second, {Position(0, 0)}, 1u << 20u);
+  const auto entryBytes = cache.getSizeInBytes() / 2;
+  BOOST_CHECK(cache.find(first));
+  cache.insert(third, {Position(0, 1)}, 2 * entryBytes);
+  BOOST_CHECK_EQUAL(cache.getSize(), 2u);
+  BOOST_CHECK(cache.find(first));
+  BOOST_CHECK(!cache.find(second));
+  const auto clicks = cache.find(third);
+  BOOST_REQUIRE(clicks);
+  BOOST_CHECK(*clicks == std::vector<Position>{Position(0, 1)});
+}
+
+BOOST_AUTO_TEST_CASE(unsolvableBoardsShouldBeRejectedWithoutSearching) {
+  BOOST_CHECK(findUnsolvabilityReason(Board::fromString("D1 D0")));
+  BOOST_CHECK(findUnsolvabilityReason(Board::fromString("B0\nH0")));
+  BOOST_CHECK(!findUnsolvabilityReason(Board::fromString("D1 D1")));
+  BOOST_CHECK_THROW(static_cast<void>(Solver().findSolution(Board::fromString("D1 D0    D1 D1"))), std::runtime_error);
+  std::mt19937 generator(44);
+  const std::string typeMix = "DDDHVTCBP";
+  for (auto trial = 0; trial < 300; trial++) {
+    std::string string;
+    for (S32 i = 0; i < 2; i++) {
+      for (S32 j = 0; j < 3; j++) {
+        string += typeMix[generator() % typeMix.size()];
+        string += generator() % 2 == 0 ? '0' : '1';
+        string += j + 1 < 3 ? ' ' : '\n';
+      }
+    }
+    const auto board = Board::fromString(string);
+    // Every board reachable by clicking any tile any number of times.
+    std::set<std::string> seenBoards{board.toString()};
+    std::vector<Board> stack{board};
+    auto solvable = false;
+    while (!stack.empty()) {
+      const auto current = stack.back();
+      stack.pop_back();
+      solvable = solvable || current.isSolved();
+      for (S32 i = 0; i < current.getRowCount(); i++) {
+        for (S32 j = 0; j < current.getColumnCount(); j++) {
+          if (current.getTile(i, j).type != TileType::Blocked) {
+            auto derivedBoard = current;
+            derivedBoard.activate(i, j);
+            if (seenBoards.insert(derivedBoard.toString()).second) {
+              stack.push_back(derivedBoard);
+            }
+          }
+        }
+      }
+    }
+    const auto reason = findUnsolvabilityReason(board);
+    if (reason) {
+      BOOST_CHECK_MESSAGE(!solvable, string + *reason);
+    } else if (board.hasCommutativeClicks()) {
+      BOOST_CHECK_MESSAGE(solvable, string);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(endgameTablesShouldAgreeWithBreadthFirstSearch) {
+  BoardSpecification specification;
+  specification.rowCount = 3;
+  specification.columnCount = 4;
+  specification.typeMix = "DDDHVTBCP";
+  specification.clickCount = 6;
+  BoardGenerator generator(45);
+  const auto directory = std::filesystem::temp_directory_path() / "wayout-player-endgame-table-test";
+  std::filesystem::remove_all(directory);
+  for (auto trial = 0; trial < 20; trial++) {
+    const auto board = generator.generate(specification).board;
+    const BoardLayout layout(board);
+    if (!EndgameTable::canBeBuilt(layout)) {
+      continue;
+    }
+    auto solver = Solver();
+    solver.getSolverConfiguration().setEngine(SolverEngine::BreadthFirst);
+    const auto expected = solver.findSolution(board);
+    solver.getSolverConfiguration().setEngine(SolverEngine::Automatic);
+    solver.getSolverConfiguration().setEndgameTableDirectory(directory.string());
+    const auto solution = solver.findSolution(board);
+    BOOST_REQUIRE_EQUAL(solution.getClicks().size(), expected.getClicks().size());
+    auto solvedBoard = board;
+    for (const auto &position : solution.getClicks()) {
+      solvedBoard.activate(position.i, position.j);
+    }
+    BOOST_CHECK(solvedBoard.isSolved());
+    const auto table = EndgameTable::build(layout);
+    const auto stored = EndgameTable::loadOrBuild(layout, directory.string());
+    BOOST_CHECK(stored.serialize() == table.serialize());
+    BOOST_CHECK_EQUAL(table.getDistance(layout, board), expected.getClicks().size());
+  }
+  // Tables are stored by the shape of the tiles, wherever they lie.
+  const BoardLayout layout(Board::fromString("D1 H0\nT1 D0"));
+  const BoardLayout translatedLayout(Board::fromString("        \n   D0 H1\n   T0 D1"));
+  BOOST_CHECK_EQUAL(EndgameTable::getFilename(layout), EndgameTable::getFilename(translatedLayout));
+  const auto stored = EndgameTable::loadOrBuild(layout, directory.string());
+  const auto reloaded = EndgameTable::loadOrBuild(translatedLayout, directory.string());
+  BOOST_CHECK(reloaded.serialize() == stored.serialize());
+  std::filesystem::remove_all(directory);
+}
+
+BOOST_AUTO_TEST_CASE(hardwareCountsShouldBeReportedPerExploredNode) {
+  const PerformanceCounters performanceCounters;
+  // Counting may be unavailable, but must never fail.
+  if (const auto counts = performanceCounters.read()) {
+    BOOST_CHECK_GT(counts->instructions, 0u);
+  }
+  HardwareCounts counts;
+  counts.instructions = 300;
+  counts.cycles = 200;
+  counts.cacheMisses = 4;
+  counts.branchMisses = 2;
+  Solution solution({}, true);
+  solution.setExploredNodes(2);
+  solution.setHardwareCounts(counts);
+  Solution otherSolution({}, true);
+  otherSolution.setExploredNodes(2);
+  otherSolution.setHardwareCounts(counts);
+  solution.add(otherSolution);
+  // Components which were not searched have no counts.
+  Solution cachedSolution({}, true);
+  cachedSolution.setExploredNodes(0);
+  solution.add(cachedSolution);
+  const auto statistics = solution.getStatisticsString();
+  const auto expected = "Per explored node: 150.00 instructions, 100.00 cycles, 2.00 cache misses, 1.00 branch misses";
+  BOOST_CHECK(statistics.find(expected) != std::string::npos);
+}
+
+BOOST_AUTO_TEST_CASE(sessionsShouldFollowTheirSolutionsWithoutSolvingAgain) {
+  auto solver = Solver();
+  Session session(solver, Board::fromString("D1 D1    D1\nD1 D0    D1\nD0 D0    D1"));
+  const auto solveCount = session.getSolveCount();
+  for (auto remaining = session.getSolution(); !remaining.getClicks().empty(); remaining = session.getSolution()) {
+    session.click(remaining.getClicks().front());
+  }
+  BOOST_CHECK(session.getBoard().isSolved());
+  BOOST_CHECK_EQUAL(session.getSolveCount(), solveCount);
+  BOOST_CHECK_THROW(session.click(Position(0, 2)), std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_CASE(sessionsShouldKeepOptimalSolutionsAfterAnyClick) {
+  BoardSpecification specification;
+  specification.rowCount = 3;
+  specification.columnCount = 4;
+  specification.density = 0.8;
+  specification.clickCount = 5;
+  BoardGenerator generator(48);
+  std::mt19937_64 clickGenerator(48);
+  for (const auto &typeMix : {"D", "DDDHVT", "DDDDDB", "DDHVTBCP"}) {
+    specification.typeMix = typeMix;
+    for (auto trial = 0; trial < 5; trial++) {
+      const auto solver = Solver();
+      const auto referenceSolver = Solver();
+      Session session(solver, generator.generate(specification).board);
+      for (auto click = 0; click < 6; click++) {
+        const auto &board = session.getBoard();
+        // Every other click follows the solution, when there is one.
+        std::optional<Position> position;
+        try {
+          const auto clicks = session.getSolution().getClicks();
+          if (click % 2 == 0 && !clicks.empty()) {
+            position = clicks.back();
+          }
+        } catch (const std::runtime_error &) {
+        }
+        while (!position) {
+          const Position candidate(static_cast<IndexType>(clickGenerator() % board.getRowCount()),
+                                   static_cast<IndexType>(clickGenerator() % board.getColumnCount()));
+          if (board.hasTile(candidate.i, candidate.j) &&
+              board.getTile(candidate.i, candidate.j).type != TileType::Blocked) {
+            position = candidate;
+          }
+        }
+        session.click(*position);
+        std::optional<Solution> expected;
+        try {
+          expected = referenceSolver.findSolution(session.getBoard());
+        } catch (const std::runtime_error &) {
+        }
+        if (!expected) {
+          BOOST_CHECK_THROW(static_cast<void>(session.getSolution()), std::runtime_error);
+          break;
+        }
+        const auto solution = session.getSolution();
+        BOOST_REQUIRE_EQUAL(solution.getClicks().size(), expected->getClicks().size());
+        auto solvedBoard = session.getBoard();
+        for (const auto &solutionClick : solution.getClicks()) {
+          solvedBoard.activate(solutionClick.i, solutionClick.j);
+        }
+        BOOST_CHECK(solvedBoard.isSolved());
+      }
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(bitPlanesShouldSpanManyWords) {
+  BitPlane plane(200);
+  BitPlane other(200);
+  for (const auto index : {3u, 64u, 130u, 199u}) {
+    plane.set(index);
+  }
+  other.set(130);
+  other.set(131);
+  BOOST_CHECK_EQUAL(plane.count(), 4u);
+  BOOST_CHECK_EQUAL(plane.findNext(4), 64u);
+  BOOST_CHECK_EQUAL(plane.findNext(131), 199u);
+  BOOST_CHECK(plane.dot(other));
+  plane ^= other;
+  BOOST_CHECK(plane.test(131) && !plane.test(130));
+  BOOST_CHECK_EQUAL(plane.findNext(200), 200u);
+  BOOST_CHECK_THROW(plane ^= BitPlane(64), std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_CASE(chasingEngineShouldAgreeWithSubsetEnumeration) {
+  BoardSpecification specification;
+  specification.rowCount = 4;
+  specification.columnCount = 4;
+  specification.density = 0.8;
+  specification.clickCount = 5;
+  BoardGenerator generator(49);
+  for (const auto &typeMix : {"D", "HV", "DDDHVT"}) {
+    specification.typeMix = typeMix;
+    for (auto trial = 0; trial < 20; trial++) {
+      const auto board = generator.generate(specification).board;
+      auto solver = Solver();
+      solver.getSolverConfiguration().setEngine(SolverEngine::SubsetEnumeration);
+      const auto expected = solver.findSolution(board);
+      solver.getSolverConfiguration().setEngine(SolverEngine::Chasing);
+      const auto solution = solver.findSolution(board);
+      BOOST_REQUIRE_EQUAL(solution.getClicks().size(), expected.getClicks().size());
+      BOOST_CHECK(solution.isOptimal());
+    }
+  }
+  auto solver = Solver();
+  solver.getSolverConfiguration().setEngine(SolverEngine::Chasing);
+  BOOST_CHECK_THROW(static_cast<void>(solver.findSolution(Board::fromString("D1 D0"))), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(beamSearchShouldSolveLargeBoardsInBoundedWidth) {
+  BoardSpecification specification;
+  specification.rowCount = 10;
+  specification.columnCount = 10;
+  specification.density = 0.9;
+  specification.typeMix = "DDDDDDDDBCPT";
+  specification.clickCount = 10;
+  BoardGenerator generator(50);
+  SolverConfiguration configuration;
+  configuration.setBeamWidth(64);
+  const BeamSearchEngine engine(configuration);
+  for (auto trial = 0; trial < 5; trial++) {
+    const auto generated = generator.generate(specification);
+    const auto solution = engine.findSolution(generated.board);
+    auto board = generated.board;
+    for (const auto &click : solution.getClicks()) {
+      board.activate(click.i, click.j);
+    }
+    BOOST_CHECK(board.isSolved());
+    BOOST_CHECK(!solution.isOptimal());
+  }
+  BOOST_CHECK_THROW(configuration.setBeamWidth(0), std::invalid_argument);
+  configuration.setBeamSearchTimeBudget(std::chrono::milliseconds(0));
+  const auto board = generator.generate(specification).board;
+  BOOST_CHECK_THROW(static_cast<void>(engine.findSolution(board)), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(beamSearchShouldSolveSmallBoards) {
+  // The solved board hashes to zero, which must not be mistaken for an empty slot of the tables of seen boards.
+  const SolverConfiguration configuration;
+  const BeamSearchEngine engine(configuration);
+  BOOST_CHECK_EQUAL(engine.findSolution(Board::fromString("D1 D1\nD0 D0")).getClicks().size(), 2u);
+  std::mt19937 generator(2050);
+  const std::string tileCharacters = "DDDHVTBCP";
+  for (auto trial = 0; trial < 20; trial++) {
+    std::string boardString;
+    for (auto i = 0; i < 3; i++) {
+      for (auto j = 0; j < 3; j++) {
+        boardString += tileCharacters[generator() % tileCharacters.size()];
+        boardString += "0";
+        boardString += j + 1 < 3 ? " " : "";
+      }
+      boardString += i + 1 < 3 ? "\n" : "";
+    }
+    auto board = Board::fromString(boardString);
+    for (auto click = 0; click < 3; click++) {
+      const auto i = static_cast<S32>(generator() % 3);
+      const auto j = static_cast<S32>(generator() % 3);
+      if (board.getTile(i, j).type != TileType::Blocked) {
+        board.activate(i, j);
+      }
+    }
+    auto solver = Solver();
+    solver.getSolverConfiguration().setEngine(SolverEngine::BreadthFirst);
+    try {
+      static_cast<void>(solver.findSolution(board));
+    } catch (const std::runtime_error &) {
+      continue;
+    }
+    const auto solution = engine.findSolution(board);
+    auto solvedBoard = board;
+    for (const auto &position : solution.getClicks()) {
+      solvedBoard.activate(position.i, position.j);
+    }
+    BOOST_CHECK(solvedBoard.isSolved());
+  }
+}
+
+BOOST_AUTO_TEST_CASE(largeBoardsShouldBeSplitAndSolved) {
+  BoardSpecification specification;
+  specification.rowCount = 150;
+  specification.columnCount = 100;
+  specification.density = 0.7;
+  specification.typeMix = "DDDHVT";
+  specification.clickCount = 1000;
+  BoardGenerator generator(49);
+  const auto generated = generator.generate(specification);
+  const auto components = generated.board.splitComponents();
+  BOOST_CHECK(components.size() > 1);
+  BOOST_CHECK(Board::mergeComponents(components) == generated.board);
+  const auto solution = Solver().findSolution(generated.board);
+  if (solution.isOptimal()) {
+    BOOST_CHECK(solution.getClicks().size() <= generated.clicks.size());
+  }
+  auto board = generated.board;
+  for (const auto &click : solution.getClicks()) {
+    board.activate(click.i, click.j);
+  }
+  BOOST_CHECK(board.isSolved());
+  std::string wideRow = "D0";
+  for (auto j = 1; j < 40000; j++) {
+    wideRow += " D0";
+  }
+  BOOST_CHECK_THROW(static_cast<void>(Board::fromString(wideRow)), std::invalid_argument);
+}